@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <twopi/core/timestamp.h>
+#include <twopi/geometry/image.h>
+#include <twopi/geometry/image_loader.h>
+
+namespace
+{
+// Wall time per image of each of num_runs calls to decode, which decodes num_images images
+std::vector<double> Measure(const std::function<void()>& decode, int num_images, int num_runs)
+{
+  std::vector<double> durations;
+  for (int i = 0; i < num_runs; i++)
+  {
+    const auto start = twopi::core::Clock::now();
+    decode();
+    durations.push_back(twopi::core::Duration(twopi::core::Clock::now() - start).count() / num_images);
+  }
+  return durations;
+}
+
+void Report(const std::string& name, std::vector<double> durations)
+{
+  std::sort(durations.begin(), durations.end());
+  std::cout << std::setw(8) << name
+    << "  min " << std::setw(10) << durations.front() * 1000. << " ms"
+    << "  median " << std::setw(10) << durations[durations.size() / 2] * 1000. << " ms" << std::endl;
+}
+}
+
+// Compares decoding copies of an image one after another with ImageLoader::LoadBatch, per image:
+//   image_decode_benchmark <image filepath> [runs] [copies]
+// e.g. with an 8K texture, where a single decode is long enough to show the batch speedup.
+int main(int argc, char** argv)
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " <image filepath> [runs] [copies]" << std::endl;
+    return 1;
+  }
+
+  const std::string filepath = argv[1];
+  const auto num_runs = argc >= 3 ? std::max(std::stoi(argv[2]), 1) : 5;
+  const auto num_copies = argc >= 4 ? std::max(std::stoi(argv[3]), 1) : 8;
+  const std::vector<std::string> filepaths(num_copies, filepath);
+
+  try
+  {
+    twopi::geometry::ImageLoader loader;
+
+    // Fails early on unreadable files, and warms the file cache
+    const auto image = loader.Load<uint8_t>(filepath);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << filepath << ", " << image->Width() << "x" << image->Height() << ", "
+      << num_copies << " copies, " << num_runs << " runs" << std::endl;
+
+    Report("sync", Measure([&] {
+      for (const auto& copy_filepath : filepaths)
+        loader.Load<uint8_t>(copy_filepath);
+      }, num_copies, num_runs));
+
+    Report("batch", Measure([&] {
+      loader.LoadBatch<uint8_t>(filepaths, [&](size_t index, std::shared_ptr<twopi::geometry::Image<uint8_t>> decoded) {
+        if (decoded == nullptr)
+          throw std::runtime_error("Failed to decode " + filepaths[index]);
+        });
+      }, num_copies, num_runs));
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <twopi/core/timestamp.h>
+#include <twopi/geometry/mesh_loader.h>
+
+namespace
+{
+constexpr int num_async_models = 4;
+
+// Wall time of each of num_runs calls to load
+std::vector<double> Measure(const std::function<void()>& load, int num_runs)
+{
+  std::vector<double> durations;
+  for (int i = 0; i < num_runs; i++)
+  {
+    const auto start = twopi::core::Clock::now();
+    load();
+    durations.push_back(twopi::core::Duration(twopi::core::Clock::now() - start).count());
+  }
+  return durations;
+}
+
+void Report(const std::string& name, std::vector<double> durations)
+{
+  std::sort(durations.begin(), durations.end());
+  std::cout << std::setw(8) << name
+    << "  min " << std::setw(10) << durations.front() * 1000. << " ms"
+    << "  median " << std::setw(10) << durations[durations.size() / 2] * 1000. << " ms" << std::endl;
+}
+}
+
+// Compares a cold assimp import with warm starts from the binary mesh cache and with concurrent imports:
+//   mesh_load_benchmark <model filepath> [runs]
+// async reports the wall time per model of num_async_models imports running at once.
+int main(int argc, char** argv)
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " <model filepath> [runs]" << std::endl;
+    return 1;
+  }
+
+  const std::string filepath = argv[1];
+  const auto num_runs = argc >= 3 ? std::max(std::stoi(argv[2]), 1) : 5;
+  const auto cache_dirpath = (std::filesystem::temp_directory_path() / "twopi_mesh_load_benchmark").string();
+
+  try
+  {
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << filepath << ", " << num_runs << " runs" << std::endl;
+
+    twopi::geometry::MeshLoader cold_loader;
+    Report("cold", Measure([&] { cold_loader.Load(filepath); }, num_runs));
+
+    auto async_durations = Measure([&] {
+      std::vector<std::future<std::shared_ptr<twopi::geometry::Model>>> models;
+      for (int i = 0; i < num_async_models; i++)
+        models.push_back(cold_loader.LoadAsync(filepath));
+      for (auto& model : models)
+        model.get();
+      }, num_runs);
+    for (auto& duration : async_durations)
+      duration /= num_async_models;
+    Report("async", async_durations);
+
+    // First load writes the cache
+    std::filesystem::remove_all(cache_dirpath);
+    twopi::geometry::MeshLoader warm_loader;
+    warm_loader.SetCacheDirpath(cache_dirpath);
+    warm_loader.Load(filepath);
+    if (warm_loader.MapCache(filepath) == nullptr)
+      throw std::runtime_error("Failed to write mesh cache to " + cache_dirpath);
+
+    // Load copies sections into meshes, while MapCache is all vkl::Engine needs before uploading
+    Report("warm", Measure([&] { warm_loader.Load(filepath); }, num_runs));
+    Report("mapped", Measure([&] { warm_loader.MapCache(filepath); }, num_runs));
+
+    std::filesystem::remove_all(cache_dirpath);
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
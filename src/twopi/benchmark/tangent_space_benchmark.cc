@@ -0,0 +1,65 @@
+#include <algorithm>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <twopi/core/timestamp.h>
+#include <twopi/geometry/mesh_loader.h>
+
+namespace
+{
+// Imports filepath repeatedly with one tangent space generator, returning the time of each generation pass
+std::vector<double> Measure(const std::string& filepath, bool assimp_tangent_space, int num_runs)
+{
+  twopi::geometry::MeshLoader loader;
+  loader.SetGenerateTangentSpace(true);
+  loader.SetAssimpTangentSpace(assimp_tangent_space);
+
+  std::vector<double> durations;
+  for (int i = 0; i < num_runs; i++)
+  {
+    loader.Load(filepath);
+    durations.push_back(loader.TangentSpaceDuration().count());
+  }
+  return durations;
+}
+
+void Report(const std::string& name, std::vector<double> durations)
+{
+  std::sort(durations.begin(), durations.end());
+  std::cout << std::setw(8) << name
+    << "  min " << std::setw(10) << durations.front() * 1000. << " ms"
+    << "  median " << std::setw(10) << durations[durations.size() / 2] * 1000. << " ms" << std::endl;
+}
+}
+
+// Compares TangentGenerator with aiProcess_CalcTangentSpace on the same asset:
+//   tangent_space_benchmark <model filepath> [runs]
+int main(int argc, char** argv)
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " <model filepath> [runs]" << std::endl;
+    return 1;
+  }
+
+  const std::string filepath = argv[1];
+  const auto num_runs = argc >= 3 ? std::max(std::stoi(argv[2]), 1) : 5;
+
+  try
+  {
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << filepath << ", " << num_runs << " runs" << std::endl;
+    Report("native", Measure(filepath, false, num_runs));
+    Report("assimp", Measure(filepath, true, num_runs));
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
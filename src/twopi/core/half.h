@@ -0,0 +1,85 @@
+#ifndef TWOPI_CORE_HALF_H_
+#define TWOPI_CORE_HALF_H_
+
+#include <cstdint>
+#include <cstring>
+
+namespace twopi
+{
+namespace core
+{
+// IEEE 754 binary16 conversion, round to nearest even
+inline uint16_t FloatToHalf(float value)
+{
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof bits);
+
+  const uint32_t sign = (bits >> 16) & 0x8000u;
+  const uint32_t abs_bits = bits & 0x7fffffffu;
+
+  // NaN and infinity
+  if (abs_bits >= 0x7f800000u)
+    return static_cast<uint16_t>(sign | 0x7c00u | (abs_bits > 0x7f800000u ? 0x0200u : 0u));
+
+  // Overflow to infinity
+  if (abs_bits >= 0x477ff000u)
+    return static_cast<uint16_t>(sign | 0x7c00u);
+
+  // Subnormal or zero
+  if (abs_bits < 0x38800000u)
+  {
+    if (abs_bits < 0x33000000u)
+      return static_cast<uint16_t>(sign);
+
+    const uint32_t exponent = abs_bits >> 23;
+    const uint32_t mantissa = (abs_bits & 0x007fffffu) | 0x00800000u;
+    const uint32_t shift = 126u - exponent;
+    uint32_t half = mantissa >> shift;
+    const uint32_t remainder = mantissa & ((1u << shift) - 1u);
+    const uint32_t halfway = 1u << (shift - 1u);
+    if (remainder > halfway || (remainder == halfway && (half & 1u)))
+      half++;
+    return static_cast<uint16_t>(sign | half);
+  }
+
+  // Normal
+  uint32_t half = ((abs_bits - 0x38000000u) >> 13);
+  const uint32_t remainder = abs_bits & 0x1fffu;
+  if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u)))
+    half++;
+  return static_cast<uint16_t>(sign | half);
+}
+
+inline float HalfToFloat(uint16_t value)
+{
+  const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+  uint32_t exponent = (value >> 10) & 0x1fu;
+  uint32_t mantissa = value & 0x03ffu;
+
+  uint32_t bits;
+  if (exponent == 0x1fu)
+    bits = sign | 0x7f800000u | (mantissa << 13);
+  else if (exponent != 0)
+    bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+  else if (mantissa == 0)
+    bits = sign;
+  else
+  {
+    // Normalize subnormal
+    exponent = 113;
+    while ((mantissa & 0x0400u) == 0)
+    {
+      mantissa <<= 1;
+      exponent--;
+    }
+    bits = sign | (exponent << 23) | ((mantissa & 0x03ffu) << 13);
+  }
+
+  float result;
+  std::memcpy(&result, &bits, sizeof result);
+  return result;
+}
+}
+}
+
+#endif // TWOPI_CORE_HALF_H_
@@ -0,0 +1,123 @@
+#include <twopi/core/mapped_file.h>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <twopi/core/error.h>
+
+namespace twopi
+{
+namespace core
+{
+class MappedFile::Impl
+{
+public:
+  Impl() = delete;
+
+  explicit Impl(const std::string& filepath)
+  {
+#ifdef _WIN32
+    file_ = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE)
+      throw Error("Failed to open file: " + filepath);
+
+    LARGE_INTEGER file_size;
+    GetFileSizeEx(file_, &file_size);
+    size_ = static_cast<size_t>(file_size.QuadPart);
+
+    if (size_ > 0)
+    {
+      mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      if (mapping_ == nullptr)
+      {
+        CloseHandle(file_);
+        throw Error("Failed to map file: " + filepath);
+      }
+
+      data_ = MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+    }
+#else
+    file_ = open(filepath.c_str(), O_RDONLY);
+    if (file_ < 0)
+      throw Error("Failed to open file: " + filepath);
+
+    struct stat file_stat;
+    fstat(file_, &file_stat);
+    size_ = static_cast<size_t>(file_stat.st_size);
+
+    if (size_ > 0)
+    {
+      data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file_, 0);
+      if (data_ == MAP_FAILED)
+      {
+        close(file_);
+        throw Error("Failed to map file: " + filepath);
+      }
+    }
+#endif
+  }
+
+  ~Impl()
+  {
+#ifdef _WIN32
+    if (data_ != nullptr)
+      UnmapViewOfFile(data_);
+    if (mapping_ != nullptr)
+      CloseHandle(mapping_);
+    CloseHandle(file_);
+#else
+    if (data_ != nullptr)
+      munmap(data_, size_);
+    close(file_);
+#endif
+  }
+
+  const void* Data() const
+  {
+    return data_;
+  }
+
+  size_t Size() const
+  {
+    return size_;
+  }
+
+private:
+#ifdef _WIN32
+  HANDLE file_ = INVALID_HANDLE_VALUE;
+  HANDLE mapping_ = nullptr;
+#else
+  int file_ = -1;
+#endif
+
+  void* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+MappedFile::MappedFile(const std::string& filepath)
+{
+  impl_ = std::make_unique<Impl>(filepath);
+}
+
+MappedFile::~MappedFile() = default;
+
+const void* MappedFile::Data() const
+{
+  return impl_->Data();
+}
+
+size_t MappedFile::Size() const
+{
+  return impl_->Size();
+}
+}
+}
@@ -0,0 +1,33 @@
+#ifndef TWOPI_CORE_MAPPED_FILE_H_
+#define TWOPI_CORE_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace twopi
+{
+namespace core
+{
+// Read-only memory mapping of a whole file
+class MappedFile
+{
+public:
+  MappedFile() = delete;
+  explicit MappedFile(const std::string& filepath);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator = (const MappedFile&) = delete;
+
+  const void* Data() const;
+  size_t Size() const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+}
+}
+
+#endif // TWOPI_CORE_MAPPED_FILE_H_
@@ -0,0 +1,191 @@
+#ifndef TWOPI_CORE_THREAD_POOL_H_
+#define TWOPI_CORE_THREAD_POOL_H_
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace twopi
+{
+namespace core
+{
+class ThreadPool
+{
+public:
+  ThreadPool()
+    : ThreadPool(std::max(1u, std::thread::hardware_concurrency()))
+  {
+  }
+
+  explicit ThreadPool(unsigned int num_threads)
+  {
+    for (unsigned int i = 0; i < num_threads; i++)
+      workers_.emplace_back([this] { Work(); });
+  }
+
+  ~ThreadPool()
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      terminate_ = true;
+    }
+    condition_.notify_all();
+
+    for (auto& worker : workers_)
+      worker.join();
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator = (const ThreadPool&) = delete;
+
+  auto NumThreads() const { return static_cast<int>(workers_.size()); }
+
+  template <typename F>
+  auto Enqueue(F&& f)
+  {
+    using ResultType = std::invoke_result_t<F>;
+
+    auto task = std::make_shared<std::packaged_task<ResultType()>>(std::forward<F>(f));
+    auto future = task->get_future();
+
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      tasks_.emplace([task] { (*task)(); });
+    }
+    condition_.notify_one();
+
+    return future;
+  }
+
+  // Calls f(begin, end) on contiguous chunks of [0, count), and blocks until all chunks are done.
+  // The caller runs queued tasks while waiting, so that f may itself call ParallelFor on the same pool.
+  template <typename F>
+  void ParallelFor(size_t count, F&& f)
+  {
+    if (count == 0)
+      return;
+
+    const size_t num_chunks = std::min(count, static_cast<size_t>(workers_.size()) * 4);
+    const size_t chunk_size = (count + num_chunks - 1) / num_chunks;
+
+    std::vector<std::future<void>> futures;
+    for (size_t begin = 0; begin < count; begin += chunk_size)
+    {
+      const auto end = std::min(count, begin + chunk_size);
+      futures.emplace_back(Enqueue([&f, begin, end] { f(begin, end); }));
+    }
+
+    for (auto& future : futures)
+    {
+      while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+      {
+        // Tasks already taken by other threads finish on their own, so waiting for them cannot deadlock
+        if (!RunPendingTask())
+          future.wait();
+      }
+      future.get();
+    }
+  }
+
+private:
+  void Work()
+  {
+    while (true)
+    {
+      std::function<void()> task;
+
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this] { return terminate_ || !tasks_.empty(); });
+
+        if (terminate_ && tasks_.empty())
+          return;
+
+        task = std::move(tasks_.front());
+        tasks_.pop();
+      }
+
+      task();
+    }
+  }
+
+  // Runs one queued task on the calling thread, returning false if the queue was empty
+  bool RunPendingTask()
+  {
+    std::function<void()> task;
+
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (tasks_.empty())
+        return false;
+
+      task = std::move(tasks_.front());
+      tasks_.pop();
+    }
+
+    task();
+    return true;
+  }
+
+  std::vector<std::thread> workers_;
+  std::queue<std::function<void()>> tasks_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  bool terminate_ = false;
+};
+
+// Pool of a helper class: either one shared by its owner, or its own, created on first use so that helpers
+// that are never used hold no threads
+class LazyThreadPool
+{
+public:
+  LazyThreadPool()
+    : LazyThreadPool(std::max(1u, std::thread::hardware_concurrency()))
+  {
+  }
+
+  explicit LazyThreadPool(unsigned int num_threads)
+    : num_threads_(num_threads)
+  {
+  }
+
+  explicit LazyThreadPool(ThreadPool& thread_pool)
+    : thread_pool_(&thread_pool)
+  {
+  }
+
+  LazyThreadPool(const LazyThreadPool&) = delete;
+  LazyThreadPool& operator = (const LazyThreadPool&) = delete;
+
+  ThreadPool& Get()
+  {
+    std::call_once(create_flag_, [this] {
+      if (thread_pool_ == nullptr)
+      {
+        own_thread_pool_ = std::make_unique<ThreadPool>(num_threads_);
+        thread_pool_ = own_thread_pool_.get();
+      }
+      });
+    return *thread_pool_;
+  }
+
+  ThreadPool* operator -> () { return &Get(); }
+
+private:
+  unsigned int num_threads_ = 0;
+  ThreadPool* thread_pool_ = nullptr;
+  std::unique_ptr<ThreadPool> own_thread_pool_;
+  std::once_flag create_flag_;
+};
+}
+}
+
+#endif // TWOPI_CORE_THREAD_POOL_H_
@@ -0,0 +1,178 @@
+#include <twopi/geometry/compressed_image.h>
+
+#include <algorithm>
+
+#include <twopi/core/error.h>
+
+namespace twopi
+{
+namespace geometry
+{
+int BlockSize(BlockFormat format)
+{
+  return format == BlockFormat::BC1 ? 8 : 16;
+}
+
+class CompressedImage::Impl
+{
+public:
+  Impl() = delete;
+
+  Impl(int width, int height, BlockFormat format)
+    : width_(width), height_(height), format_(format)
+  {
+  }
+
+  ~Impl() = default;
+
+  int Width() const
+  {
+    return width_;
+  }
+
+  int Height() const
+  {
+    return height_;
+  }
+
+  BlockFormat Format() const
+  {
+    return format_;
+  }
+
+  void SetSrgb(bool srgb)
+  {
+    srgb_ = srgb;
+  }
+
+  bool IsSrgb() const
+  {
+    return srgb_;
+  }
+
+  void AddLevel(std::vector<uint8_t>&& blocks)
+  {
+    const auto level = static_cast<int>(levels_.size());
+    if (blocks.size() != LevelSize(level))
+      throw core::Error("Compressed image level " + std::to_string(level) + " has " + std::to_string(blocks.size()) + " bytes, expected " + std::to_string(LevelSize(level)));
+
+    levels_.emplace_back(std::move(blocks));
+  }
+
+  int NumLevels() const
+  {
+    return static_cast<int>(levels_.size());
+  }
+
+  int LevelWidth(int level) const
+  {
+    return std::max(width_ >> level, 1);
+  }
+
+  int LevelHeight(int level) const
+  {
+    return std::max(height_ >> level, 1);
+  }
+
+  const std::vector<uint8_t>& Level(int level) const
+  {
+    return levels_[level];
+  }
+
+  int BlocksX(int level) const
+  {
+    return (LevelWidth(level) + 3) / 4;
+  }
+
+  int BlocksY(int level) const
+  {
+    return (LevelHeight(level) + 3) / 4;
+  }
+
+  size_t LevelSize(int level) const
+  {
+    return static_cast<size_t>(BlocksX(level)) * BlocksY(level) * BlockSize(format_);
+  }
+
+private:
+  int width_;
+  int height_;
+  BlockFormat format_;
+  bool srgb_ = false;
+
+  std::vector<std::vector<uint8_t>> levels_;
+};
+
+CompressedImage::CompressedImage(int width, int height, BlockFormat format)
+{
+  impl_ = std::make_unique<Impl>(width, height, format);
+}
+
+CompressedImage::~CompressedImage() = default;
+
+int CompressedImage::Width() const
+{
+  return impl_->Width();
+}
+
+int CompressedImage::Height() const
+{
+  return impl_->Height();
+}
+
+BlockFormat CompressedImage::Format() const
+{
+  return impl_->Format();
+}
+
+void CompressedImage::SetSrgb(bool srgb)
+{
+  impl_->SetSrgb(srgb);
+}
+
+bool CompressedImage::IsSrgb() const
+{
+  return impl_->IsSrgb();
+}
+
+void CompressedImage::AddLevel(std::vector<uint8_t>&& blocks)
+{
+  impl_->AddLevel(std::move(blocks));
+}
+
+int CompressedImage::NumLevels() const
+{
+  return impl_->NumLevels();
+}
+
+int CompressedImage::LevelWidth(int level) const
+{
+  return impl_->LevelWidth(level);
+}
+
+int CompressedImage::LevelHeight(int level) const
+{
+  return impl_->LevelHeight(level);
+}
+
+const std::vector<uint8_t>& CompressedImage::Level(int level) const
+{
+  return impl_->Level(level);
+}
+
+int CompressedImage::BlocksX(int level) const
+{
+  return impl_->BlocksX(level);
+}
+
+int CompressedImage::BlocksY(int level) const
+{
+  return impl_->BlocksY(level);
+}
+
+size_t CompressedImage::LevelSize(int level) const
+{
+  return impl_->LevelSize(level);
+}
+}
+}
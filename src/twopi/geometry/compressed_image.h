@@ -0,0 +1,61 @@
+#ifndef TWOPI_GEOMETRY_COMPRESSED_IMAGE_H_
+#define TWOPI_GEOMETRY_COMPRESSED_IMAGE_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace twopi
+{
+namespace geometry
+{
+// Block compressed formats of 4x4 pixel blocks, in the bit layout GPUs sample directly
+enum class BlockFormat : uint32_t
+{
+  BC1 = 0, // RGB with 1-bit alpha, 8 bytes per block
+  BC3,     // RGBA, BC1 color and BC4 alpha, 16 bytes per block
+  BC5,     // RG from two BC4 channels, for normal maps, 16 bytes per block
+  BC7,     // RGBA, 16 bytes per block
+};
+
+// Bytes per 4x4 block
+int BlockSize(BlockFormat format);
+
+// Mip levels of block compressed pixels. Unlike Image, block rows are stored from the top of the image,
+// as in DDS and KTX files and as vkl::Texture uploads every format; TextureEncoder reads Image rows in reverse.
+class CompressedImage
+{
+public:
+  CompressedImage() = delete;
+  CompressedImage(int width, int height, BlockFormat format);
+  ~CompressedImage();
+
+  int Width() const;
+  int Height() const;
+  BlockFormat Format() const;
+
+  // Color textures are sampled with sRGB decoding; data textures such as normal maps are not
+  void SetSrgb(bool srgb);
+  bool IsSrgb() const;
+
+  // Appends the next level, of LevelWidth(NumLevels()) x LevelHeight(NumLevels()) pixels
+  void AddLevel(std::vector<uint8_t>&& blocks);
+
+  int NumLevels() const;
+  int LevelWidth(int level) const;
+  int LevelHeight(int level) const;
+  const std::vector<uint8_t>& Level(int level) const;
+
+  // Blocks of a level, counting partial blocks at the right and bottom edges
+  int BlocksX(int level) const;
+  int BlocksY(int level) const;
+  size_t LevelSize(int level) const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+}
+}
+
+#endif // TWOPI_GEOMETRY_COMPRESSED_IMAGE_H_
@@ -0,0 +1,212 @@
+#include <twopi/geometry/dds.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+#include <twopi/core/error.h>
+#include <twopi/geometry/compressed_image.h>
+
+namespace twopi
+{
+namespace geometry
+{
+namespace
+{
+constexpr uint32_t FourCc(char a, char b, char c, char d)
+{
+  return static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8) | (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24);
+}
+
+constexpr uint32_t dds_magic = FourCc('D', 'D', 'S', ' ');
+
+constexpr uint32_t ddsd_caps = 0x1;
+constexpr uint32_t ddsd_height = 0x2;
+constexpr uint32_t ddsd_width = 0x4;
+constexpr uint32_t ddsd_pixelformat = 0x1000;
+constexpr uint32_t ddsd_mipmapcount = 0x20000;
+constexpr uint32_t ddsd_linearsize = 0x80000;
+constexpr uint32_t ddpf_fourcc = 0x4;
+constexpr uint32_t ddscaps_complex = 0x8;
+constexpr uint32_t ddscaps_texture = 0x1000;
+constexpr uint32_t ddscaps_mipmap = 0x400000;
+constexpr uint32_t d3d10_resource_dimension_texture2d = 3;
+
+enum DxgiFormat : uint32_t
+{
+  DXGI_FORMAT_BC1_UNORM = 71,
+  DXGI_FORMAT_BC1_UNORM_SRGB = 72,
+  DXGI_FORMAT_BC3_UNORM = 77,
+  DXGI_FORMAT_BC3_UNORM_SRGB = 78,
+  DXGI_FORMAT_BC5_UNORM = 83,
+  DXGI_FORMAT_BC7_UNORM = 98,
+  DXGI_FORMAT_BC7_UNORM_SRGB = 99,
+};
+
+struct DdsPixelFormat
+{
+  uint32_t size;
+  uint32_t flags;
+  uint32_t four_cc;
+  uint32_t rgb_bit_count;
+  uint32_t bit_masks[4];
+};
+
+struct DdsHeader
+{
+  uint32_t size;
+  uint32_t flags;
+  uint32_t height;
+  uint32_t width;
+  uint32_t pitch_or_linear_size;
+  uint32_t depth;
+  uint32_t mip_map_count;
+  uint32_t reserved1[11];
+  DdsPixelFormat pixel_format;
+  uint32_t caps[4];
+  uint32_t reserved2;
+};
+
+struct DdsHeaderDx10
+{
+  uint32_t dxgi_format;
+  uint32_t resource_dimension;
+  uint32_t misc_flag;
+  uint32_t array_size;
+  uint32_t misc_flags2;
+};
+
+static_assert(sizeof(DdsHeader) == 124, "DDS header must be 124 bytes");
+static_assert(sizeof(DdsHeaderDx10) == 20, "DDS DX10 header must be 20 bytes");
+
+uint32_t ToDxgiFormat(BlockFormat format, bool srgb)
+{
+  switch (format)
+  {
+  case BlockFormat::BC1: return srgb ? DXGI_FORMAT_BC1_UNORM_SRGB : DXGI_FORMAT_BC1_UNORM;
+  case BlockFormat::BC3: return srgb ? DXGI_FORMAT_BC3_UNORM_SRGB : DXGI_FORMAT_BC3_UNORM;
+  case BlockFormat::BC5: return DXGI_FORMAT_BC5_UNORM;
+  case BlockFormat::BC7: return srgb ? DXGI_FORMAT_BC7_UNORM_SRGB : DXGI_FORMAT_BC7_UNORM;
+  }
+  return 0;
+}
+
+bool FromDxgiFormat(uint32_t dxgi_format, BlockFormat& format, bool& srgb)
+{
+  srgb = dxgi_format == DXGI_FORMAT_BC1_UNORM_SRGB || dxgi_format == DXGI_FORMAT_BC3_UNORM_SRGB || dxgi_format == DXGI_FORMAT_BC7_UNORM_SRGB;
+  switch (dxgi_format)
+  {
+  case DXGI_FORMAT_BC1_UNORM:
+  case DXGI_FORMAT_BC1_UNORM_SRGB:
+    format = BlockFormat::BC1;
+    return true;
+  case DXGI_FORMAT_BC3_UNORM:
+  case DXGI_FORMAT_BC3_UNORM_SRGB:
+    format = BlockFormat::BC3;
+    return true;
+  case DXGI_FORMAT_BC5_UNORM:
+    format = BlockFormat::BC5;
+    return true;
+  case DXGI_FORMAT_BC7_UNORM:
+  case DXGI_FORMAT_BC7_UNORM_SRGB:
+    format = BlockFormat::BC7;
+    return true;
+  default:
+    return false;
+  }
+}
+}
+
+void SaveDds(const std::string& filepath, const CompressedImage& image)
+{
+  const auto num_levels = std::max(image.NumLevels(), 1);
+
+  DdsHeader header = {};
+  header.size = sizeof(DdsHeader);
+  header.flags = ddsd_caps | ddsd_height | ddsd_width | ddsd_pixelformat | ddsd_mipmapcount | ddsd_linearsize;
+  header.height = image.Height();
+  header.width = image.Width();
+  header.pitch_or_linear_size = static_cast<uint32_t>(image.LevelSize(0));
+  header.mip_map_count = num_levels;
+  header.pixel_format.size = sizeof(DdsPixelFormat);
+  header.pixel_format.flags = ddpf_fourcc;
+  header.pixel_format.four_cc = FourCc('D', 'X', '1', '0');
+  header.caps[0] = ddscaps_texture | (num_levels > 1 ? ddscaps_complex | ddscaps_mipmap : 0);
+
+  DdsHeaderDx10 header_dx10 = {};
+  header_dx10.dxgi_format = ToDxgiFormat(image.Format(), image.IsSrgb());
+  header_dx10.resource_dimension = d3d10_resource_dimension_texture2d;
+  header_dx10.array_size = 1;
+
+  std::ofstream out(filepath, std::ios::binary | std::ios::trunc);
+  if (!out.is_open())
+    throw core::Error("Failed to open file: " + filepath);
+
+  out.write(reinterpret_cast<const char*>(&dds_magic), sizeof dds_magic);
+  out.write(reinterpret_cast<const char*>(&header), sizeof header);
+  out.write(reinterpret_cast<const char*>(&header_dx10), sizeof header_dx10);
+  for (int level = 0; level < image.NumLevels(); level++)
+    out.write(reinterpret_cast<const char*>(image.Level(level).data()), image.Level(level).size());
+
+  if (!out)
+    throw core::Error("Failed to write file: " + filepath);
+}
+
+std::shared_ptr<CompressedImage> LoadDds(const std::string& filepath)
+{
+  std::ifstream in(filepath, std::ios::binary);
+  if (!in.is_open())
+    throw core::Error("Failed to open file: " + filepath);
+
+  uint32_t magic = 0;
+  DdsHeader header = {};
+  in.read(reinterpret_cast<char*>(&magic), sizeof magic);
+  in.read(reinterpret_cast<char*>(&header), sizeof header);
+  if (!in || magic != dds_magic || header.size != sizeof(DdsHeader))
+    throw core::Error("Not a DDS file: " + filepath);
+
+  BlockFormat format = BlockFormat::BC1;
+  bool srgb = false;
+  const auto four_cc = (header.pixel_format.flags & ddpf_fourcc) ? header.pixel_format.four_cc : 0;
+  if (four_cc == FourCc('D', 'X', '1', '0'))
+  {
+    DdsHeaderDx10 header_dx10 = {};
+    in.read(reinterpret_cast<char*>(&header_dx10), sizeof header_dx10);
+    if (!in || header_dx10.resource_dimension != d3d10_resource_dimension_texture2d || header_dx10.array_size > 1 ||
+      !FromDxgiFormat(header_dx10.dxgi_format, format, srgb))
+      throw core::Error("Unsupported DDS format in " + filepath);
+  }
+  else if (four_cc == FourCc('D', 'X', 'T', '1'))
+    format = BlockFormat::BC1;
+  else if (four_cc == FourCc('D', 'X', 'T', '5'))
+    format = BlockFormat::BC3;
+  else if (four_cc == FourCc('A', 'T', 'I', '2') || four_cc == FourCc('B', 'C', '5', 'U'))
+    format = BlockFormat::BC5;
+  else
+    throw core::Error("Unsupported DDS format in " + filepath);
+
+  if (header.width == 0 || header.height == 0)
+    throw core::Error("Empty DDS image: " + filepath);
+
+  auto image = std::make_shared<CompressedImage>(header.width, header.height, format);
+  image->SetSrgb(srgb);
+
+  // Levels below 1x1 do not exist, whatever the header claims
+  uint32_t max_levels = 1;
+  while ((std::max(header.width, header.height) >> max_levels) > 0)
+    max_levels++;
+  const auto num_levels = (header.flags & ddsd_mipmapcount) ? std::clamp(header.mip_map_count, 1u, max_levels) : 1u;
+  for (uint32_t level = 0; level < num_levels; level++)
+  {
+    std::vector<uint8_t> blocks(image->LevelSize(level));
+    in.read(reinterpret_cast<char*>(blocks.data()), blocks.size());
+    if (!in)
+      throw core::Error("Truncated DDS file: " + filepath);
+    image->AddLevel(std::move(blocks));
+  }
+
+  return image;
+}
+}
+}
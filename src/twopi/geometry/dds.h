@@ -0,0 +1,22 @@
+#ifndef TWOPI_GEOMETRY_DDS_H_
+#define TWOPI_GEOMETRY_DDS_H_
+
+#include <memory>
+#include <string>
+
+namespace twopi
+{
+namespace geometry
+{
+class CompressedImage;
+
+// Writes a DDS file with a DX10 header, readable by common texture tools
+void SaveDds(const std::string& filepath, const CompressedImage& image);
+
+// Reads block compressed 2D DDS files with a DX10 header or a DXT1, DXT5, ATI2 or BC5U four character code.
+// Mip levels are read straight into the image's storage.
+std::shared_ptr<CompressedImage> LoadDds(const std::string& filepath);
+}
+}
+
+#endif // TWOPI_GEOMETRY_DDS_H_
@@ -0,0 +1,106 @@
+#include <twopi/geometry/hdr_encoding.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <twopi/core/half.h>
+#include <twopi/geometry/image.h>
+
+namespace twopi
+{
+namespace geometry
+{
+namespace
+{
+constexpr int mantissa_bits = 9;
+constexpr int exponent_bias = 15;
+constexpr int max_exponent = 31;
+
+// 511/512 * 2^16, the largest representable value
+constexpr float max_rgb9e5 = static_cast<float>((1 << mantissa_bits) - 1) / (1 << mantissa_bits) * static_cast<float>(1 << (max_exponent - exponent_bias));
+
+float ClampRgb9e5(float value)
+{
+  // NaN fails the comparison and becomes 0
+  return value > 0.f ? std::min(value, max_rgb9e5) : 0.f;
+}
+}
+
+std::shared_ptr<Image<uint16_t>> ConvertToHalf(const Image<float>& image)
+{
+  const auto comp = image.Comp();
+  const auto half_comp = comp == 3 ? 4 : comp;
+  const auto num_pixels = static_cast<size_t>(image.Width()) * image.Height();
+  auto result = std::make_shared<Image<uint16_t>>(image.Width(), image.Height(), half_comp);
+
+  const auto* src = image.Data();
+  auto* dst = result->Data();
+  for (size_t i = 0; i < num_pixels; i++)
+  {
+    for (int c = 0; c < comp; c++)
+      dst[i * half_comp + c] = core::FloatToHalf(src[i * comp + c]);
+    if (half_comp != comp)
+      dst[i * half_comp + 3] = core::FloatToHalf(1.f);
+  }
+
+  return result;
+}
+
+std::shared_ptr<Image<uint32_t>> ConvertToRgb9e5(const Image<float>& image)
+{
+  const auto comp = image.Comp();
+  const auto num_pixels = static_cast<size_t>(image.Width()) * image.Height();
+  auto result = std::make_shared<Image<uint32_t>>(image.Width(), image.Height(), 1);
+
+  const auto* src = image.Data();
+  auto* dst = result->Data();
+  for (size_t i = 0; i < num_pixels; i++)
+  {
+    const auto* pixel = src + i * comp;
+    dst[i] = comp >= 3 ? PackRgb9e5(pixel[0], pixel[1], pixel[2]) : PackRgb9e5(pixel[0], pixel[0], pixel[0]);
+  }
+
+  return result;
+}
+
+uint32_t PackRgb9e5(float r, float g, float b)
+{
+  r = ClampRgb9e5(r);
+  g = ClampRgb9e5(g);
+  b = ClampRgb9e5(b);
+  const auto max_component = std::max({ r, g, b });
+
+  // floor(log2(max_component)), from the exponent of a mantissa in [0.5, 1)
+  int exponent = -exponent_bias - 1;
+  if (max_component > 0.f)
+  {
+    std::frexp(max_component, &exponent);
+    exponent = std::max(exponent - 1, -exponent_bias - 1);
+  }
+  int shared_exponent = exponent + 1 + exponent_bias;
+
+  // Rounding may carry the largest mantissa over to the next exponent
+  auto scale = std::ldexp(1.f, mantissa_bits + exponent_bias - shared_exponent);
+  if (static_cast<int>(std::floor(max_component * scale + 0.5f)) == (1 << mantissa_bits))
+  {
+    shared_exponent++;
+    scale *= 0.5f;
+  }
+
+  const auto quantize = [scale](float value) {
+    return static_cast<uint32_t>(std::floor(value * scale + 0.5f));
+  };
+  return quantize(r) | (quantize(g) << 9) | (quantize(b) << 18) | (static_cast<uint32_t>(shared_exponent) << 27);
+}
+
+std::array<float, 3> UnpackRgb9e5(uint32_t packed)
+{
+  const auto scale = std::ldexp(1.f, static_cast<int>(packed >> 27) - exponent_bias - mantissa_bits);
+  return {
+    static_cast<float>(packed & 0x1ffu) * scale,
+    static_cast<float>((packed >> 9) & 0x1ffu) * scale,
+    static_cast<float>((packed >> 18) & 0x1ffu) * scale,
+  };
+}
+}
+}
@@ -0,0 +1,29 @@
+#ifndef TWOPI_GEOMETRY_HDR_ENCODING_H_
+#define TWOPI_GEOMETRY_HDR_ENCODING_H_
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+namespace twopi
+{
+namespace geometry
+{
+template <typename T>
+class Image;
+
+// Half float components for R16, R16G16 and R16G16B16A16 formats. RGB images gain an alpha of 1, since GPUs
+// rarely sample 3 component half formats; that is still 8 bytes per pixel against 12 for RGB floats.
+std::shared_ptr<Image<uint16_t>> ConvertToHalf(const Image<float>& image);
+
+// Shared exponent RGB in one uint32_t per pixel for the E5B9G9R9 format, 4 bytes per pixel. Alpha is dropped,
+// gray images are replicated to RGB, and negative values clamp to 0.
+std::shared_ptr<Image<uint32_t>> ConvertToRgb9e5(const Image<float>& image);
+
+// RGB9E5 encoding of EXT_texture_shared_exponent, with components rounded to nearest
+uint32_t PackRgb9e5(float r, float g, float b);
+std::array<float, 3> UnpackRgb9e5(uint32_t packed);
+}
+}
+
+#endif // TWOPI_GEOMETRY_HDR_ENCODING_H_
@@ -1,7 +1,8 @@
 #include <twopi/geometry/image.h>
 
-#include <iterator>
 #include <algorithm>
+#include <cstdint>
+#include <cstdlib>
 
 namespace twopi
 {
@@ -17,6 +18,13 @@ public:
 
   Impl(int width, int height, int comp)
     : width_(width), height_(height), comp_(comp)
+    , pixels_(static_cast<T*>(std::calloc(Size(), sizeof(T))), std::free)
+  {
+  }
+
+  Impl(int width, int height, int comp, T* pixels, Deleter deleter)
+    : width_(width), height_(height), comp_(comp)
+    , pixels_(pixels, deleter)
   {
   }
 
@@ -26,12 +34,14 @@ public:
 
   void CopyBuffer(const T* const buffer)
   {
-    buffer_.clear();
-
     // Pixels in buffer are stored from top-left, left-to-right, to bottom-right.
     // Store this image from bottom-left, left-to-right, to top-right, by flipping the scanline order
+    if (pixels_ == nullptr)
+      pixels_.reset(static_cast<T*>(std::malloc(Size() * sizeof(T))));
+
+    const auto row_size = static_cast<size_t>(width_) * comp_;
     for (int r = 0; r < height_; r++)
-      std::copy(buffer + (height_ - r - 1) * width_ * comp_, buffer + (height_ - r) * width_ * comp_, std::back_inserter(buffer_));
+      std::copy_n(buffer + (height_ - r - 1) * row_size, row_size, pixels_.get() + r * row_size);
   }
 
   int Width() const
@@ -49,17 +59,27 @@ public:
     return comp_;
   }
 
-  const std::vector<T>& Buffer() const
+  size_t Size() const
+  {
+    return static_cast<size_t>(width_) * height_ * comp_;
+  }
+
+  const T* Data() const
+  {
+    return pixels_.get();
+  }
+
+  T* Data()
   {
-    return buffer_;
+    return pixels_.get();
   }
 
 private:
-  int width_ = 1;
-  int height_ = 1;
-  int comp_ = 1;
+  int width_ = 0;
+  int height_ = 0;
+  int comp_ = 0;
 
-  std::vector<T> buffer_;
+  std::unique_ptr<T, Deleter> pixels_{ nullptr, std::free };
 };
 
 template <typename T>
@@ -74,6 +94,12 @@ Image<T>::Image(int width, int height, int comp)
   impl_ = std::make_unique<Impl>(width, height, comp);
 }
 
+template <typename T>
+Image<T>::Image(int width, int height, int comp, T* pixels, Deleter deleter)
+{
+  impl_ = std::make_unique<Impl>(width, height, comp, pixels, deleter);
+}
+
 template <typename T>
 Image<T>::~Image() = default;
 
@@ -102,13 +128,27 @@ int Image<T>::Comp() const
 }
 
 template <typename T>
-const std::vector<T>& Image<T>::Buffer() const
+size_t Image<T>::Size() const
+{
+  return impl_->Size();
+}
+
+template <typename T>
+const T* Image<T>::Data() const
+{
+  return impl_->Data();
+}
+
+template <typename T>
+T* Image<T>::Data()
 {
-  return impl_->Buffer();
+  return impl_->Data();
 }
 
 // Template instantiation
 template class Image<uint8_t>;
+template class Image<uint16_t>;
+template class Image<uint32_t>;
 template class Image<float>;
 }
 }
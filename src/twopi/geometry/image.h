@@ -1,27 +1,40 @@
 #ifndef TWOPI_GEOMETRY_IMAGE_H_
 #define TWOPI_GEOMETRY_IMAGE_H_
 
+#include <cstddef>
 #include <memory>
-#include <vector>
 
 namespace twopi
 {
 namespace geometry
 {
+// Pixels are stored from bottom-left, left-to-right, to top-right, comp elements per pixel.
+// vkl::Texture reverses the rows on upload, since GPU images start at the top row as CompressedImage does.
 template <typename T>
 class Image
 {
+public:
+  using Deleter = void (*)(void*);
+
 public:
   Image();
-  Image(int wodtj, int height, int comp);
+  // Zero-initialized pixels
+  Image(int width, int height, int comp);
+  // Takes ownership of pixels already in bottom-up order, released with deleter, e.g. stbi_image_free
+  Image(int width, int height, int comp, T* pixels, Deleter deleter);
   ~Image();
 
+  // Copies pixels stored from top-left, flipping the scanline order
   void CopyBuffer(const T* const buffer);
 
   int Width() const;
   int Height() const;
   int Comp() const;
-  const std::vector<T>& Buffer() const;
+
+  // Width * Height * Comp elements
+  size_t Size() const;
+  const T* Data() const;
+  T* Data();
 
 private:
   class Impl;
@@ -1,8 +1,16 @@
 #include <twopi/geometry/image_loader.h>
 
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+#include <twopi/core/thread_pool.h>
+#include <twopi/geometry/compressed_image.h>
+#include <twopi/geometry/dds.h>
 #include <twopi/geometry/image.h>
 
 namespace twopi
@@ -21,26 +29,108 @@ public:
   template <typename T>
   std::shared_ptr<Image<T>> Load(const std::string& filepath);
 
-  template <>
-  std::shared_ptr<Image<uint8_t>> Load(const std::string& filepath)
+  template <typename T>
+  std::future<std::shared_ptr<Image<T>>> LoadAsync(const std::string& filepath)
+  {
+    return decode_thread_pool_->Enqueue([this, filepath] { return Load<T>(filepath); });
+  }
+
+  template <typename T>
+  void LoadBatch(const std::vector<std::string>& filepaths, const std::function<void(size_t, std::shared_ptr<Image<T>>)>& on_loaded)
   {
-    int width = 1;
-    int height = 1;
-    int comp = 1;
+    std::vector<std::shared_ptr<Image<T>>> images(filepaths.size());
+    std::queue<size_t> finished;
+    std::mutex mutex;
+    std::condition_variable condition;
 
-    unsigned char* data = stbi_load(filepath.c_str(), &width, &height, &comp, STBI_rgb_alpha);
-    comp = STBI_rgb_alpha;
+    std::vector<std::future<void>> futures;
+    futures.reserve(filepaths.size());
+    for (size_t i = 0; i < filepaths.size(); i++)
+    {
+      futures.emplace_back(decode_thread_pool_->Enqueue([this, i, &filepaths, &images, &finished, &mutex, &condition] {
+        std::shared_ptr<Image<T>> image;
+        try
+        {
+          image = Load<T>(filepaths[i]);
+        }
+        catch (const std::exception&)
+        {
+        }
 
-    const auto image = std::make_shared<Image<uint8_t>>(height, width, comp);
-    image->CopyBuffer(data);
-    stbi_image_free(data);
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          images[i] = std::move(image);
+          finished.push(i);
+        }
+        condition.notify_one();
+        }));
+    }
 
-    return image;
+    // Tasks reference locals, so they must finish even if a callback throws
+    try
+    {
+      for (size_t n = 0; n < filepaths.size(); n++)
+      {
+        size_t index;
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          condition.wait(lock, [&finished] { return !finished.empty(); });
+          index = finished.front();
+          finished.pop();
+        }
+
+        on_loaded(index, std::move(images[index]));
+      }
+    }
+    catch (...)
+    {
+      for (auto& future : futures)
+        future.wait();
+      throw;
+    }
   }
 
 private:
+  // Declared last, so that workers are joined before the rest of the loader is destroyed
+  core::LazyThreadPool decode_thread_pool_;
 };
 
+template <>
+std::shared_ptr<Image<uint8_t>> ImageLoader::Impl::Load(const std::string& filepath)
+{
+  int width = 0;
+  int height = 0;
+  int comp = 0;
+
+  // Decoded bottom-up, straight into the storage the image adopts
+  stbi_set_flip_vertically_on_load_thread(1);
+  unsigned char* data = stbi_load(filepath.c_str(), &width, &height, &comp, STBI_rgb_alpha);
+  if (data == nullptr)
+    throw std::runtime_error("Failed to load image " + filepath + ": " + stbi_failure_reason());
+  comp = STBI_rgb_alpha;
+
+  const auto image = std::make_shared<Image<uint8_t>>(width, height, comp, data, stbi_image_free);
+
+  return image;
+}
+
+// Radiance HDR files in linear float; 8-bit files are converted from sRGB by stb
+template <>
+std::shared_ptr<Image<float>> ImageLoader::Impl::Load(const std::string& filepath)
+{
+  int width = 0;
+  int height = 0;
+  int comp = 0;
+
+  // HDR files keep their 3 components rather than paying for an alpha of 1
+  stbi_set_flip_vertically_on_load_thread(1);
+  float* data = stbi_loadf(filepath.c_str(), &width, &height, &comp, 0);
+  if (data == nullptr)
+    throw std::runtime_error("Failed to load image " + filepath + ": " + stbi_failure_reason());
+
+  return std::make_shared<Image<float>>(width, height, comp, data, stbi_image_free);
+}
+
 ImageLoader::ImageLoader()
 {
   impl_ = std::make_unique<Impl>();
@@ -54,6 +144,28 @@ std::shared_ptr<Image<T>> ImageLoader::Load(const std::string& filepath)
   return impl_->Load<T>(filepath);
 }
 
+std::shared_ptr<CompressedImage> ImageLoader::LoadCompressed(const std::string& filepath)
+{
+  return LoadDds(filepath);
+}
+
+template <typename T>
+std::future<std::shared_ptr<Image<T>>> ImageLoader::LoadAsync(const std::string& filepath)
+{
+  return impl_->LoadAsync<T>(filepath);
+}
+
+template <typename T>
+void ImageLoader::LoadBatch(const std::vector<std::string>& filepaths, const std::function<void(size_t, std::shared_ptr<Image<T>>)>& on_loaded)
+{
+  impl_->LoadBatch<T>(filepaths, on_loaded);
+}
+
 template std::shared_ptr<Image<uint8_t>> ImageLoader::Load(const std::string& filepath);
+template std::future<std::shared_ptr<Image<uint8_t>>> ImageLoader::LoadAsync(const std::string& filepath);
+template void ImageLoader::LoadBatch(const std::vector<std::string>& filepaths, const std::function<void(size_t, std::shared_ptr<Image<uint8_t>>)>& on_loaded);
+template std::shared_ptr<Image<float>> ImageLoader::Load(const std::string& filepath);
+template std::future<std::shared_ptr<Image<float>>> ImageLoader::LoadAsync(const std::string& filepath);
+template void ImageLoader::LoadBatch(const std::vector<std::string>& filepaths, const std::function<void(size_t, std::shared_ptr<Image<float>>)>& on_loaded);
 }
 }
@@ -1,8 +1,11 @@
 #ifndef TWOPI_GEOMETRY_IMAGE_LOADER_H_
 #define TWOPI_GEOMETRY_IMAGE_LOADER_H_
 
+#include <functional>
+#include <future>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace twopi
 {
@@ -10,6 +13,7 @@ namespace geometry
 {
 template <typename T>
 class Image;
+class CompressedImage;
 
 class ImageLoader
 {
@@ -17,9 +21,23 @@ public:
   ImageLoader();
   ~ImageLoader();
 
+  // uint8_t decodes to 4 components; float decodes Radiance HDR files to linear RGB, e.g. for environment maps,
+  // to be stored with ConvertToHalf or ConvertToRgb9e5
   template <typename T>
   std::shared_ptr<Image<T>> Load(const std::string& filepath);
 
+  // Block compressed DDS file, read without decoding, e.g. as written by TextureEncoder and SaveDds
+  std::shared_ptr<CompressedImage> LoadCompressed(const std::string& filepath);
+
+  // Decodes on a worker thread; the future rethrows decode errors
+  template <typename T>
+  std::future<std::shared_ptr<Image<T>>> LoadAsync(const std::string& filepath);
+
+  // Decodes all files concurrently and calls on_loaded(index, image) on the calling thread in completion order,
+  // returning after the last one. image is nullptr if the file at index fails to decode.
+  template <typename T>
+  void LoadBatch(const std::vector<std::string>& filepaths, const std::function<void(size_t, std::shared_ptr<Image<T>>)>& on_loaded);
+
 private:
   class Impl;
   std::unique_ptr<Impl> impl_;
@@ -1,5 +1,16 @@
 #include <twopi/geometry/mesh.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <twopi/geometry/texture_table.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TWOPI_GEOMETRY_MESH_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace twopi
 {
 namespace geometry
@@ -28,14 +39,58 @@ public:
     tex_coords_ = std::move(tex_coords);
   }
 
+  void SetTangents(std::vector<float>&& tangents)
+  {
+    tangents_ = std::move(tangents);
+  }
+
+  void SetInterleavedVertices(std::vector<float>&& interleaved_vertices)
+  {
+    interleaved_vertices_ = std::move(interleaved_vertices);
+  }
+
+  void SetCompressedVertices(std::vector<uint16_t>&& compressed_vertices)
+  {
+    compressed_vertices_ = std::move(compressed_vertices);
+  }
+
+  void SetPositionDequantization(const std::array<float, 3>& offset, const std::array<float, 3>& scale)
+  {
+    position_offset_ = offset;
+    position_scale_ = scale;
+  }
+
   void SetIndices(std::vector<uint32_t>&& indices)
   {
     indices_ = std::move(indices);
+    UpdateShortIndices();
+  }
+
+  void SetIndices(const std::vector<uint16_t>& indices)
+  {
+    indices_.assign(indices.begin(), indices.end());
+    UpdateShortIndices();
+  }
+
+  void SetTextureId(TextureSlot slot, uint32_t texture_id)
+  {
+    texture_ids_[static_cast<uint32_t>(slot)] = texture_id;
+  }
+
+  void SetLods(std::vector<MeshLod>&& lods)
+  {
+    lods_ = std::move(lods);
+    UpdateShortIndices();
   }
 
-  void SetTextureFilepath(std::string&& texture_filepath)
+  void SetMeshlets(std::vector<Meshlet>&& meshlets)
   {
-    texture_filepath_ = std::move(texture_filepath);
+    meshlets_ = std::move(meshlets);
+  }
+
+  void SetBounds(const MeshBounds& bounds)
+  {
+    bounds_ = bounds;
   }
 
   const std::vector<float>& Vertices() const
@@ -53,22 +108,315 @@ public:
     return tex_coords_;
   }
 
+  const std::vector<float>& Tangents() const
+  {
+    return tangents_;
+  }
+
+  const std::vector<float>& InterleavedVertices() const
+  {
+    return interleaved_vertices_;
+  }
+
+  bool IsInterleaved() const
+  {
+    return !interleaved_vertices_.empty();
+  }
+
+  const std::vector<uint16_t>& CompressedVertices() const
+  {
+    return compressed_vertices_;
+  }
+
+  bool IsCompressed() const
+  {
+    return !compressed_vertices_.empty();
+  }
+
+  const std::array<float, 3>& PositionOffset() const
+  {
+    return position_offset_;
+  }
+
+  const std::array<float, 3>& PositionScale() const
+  {
+    return position_scale_;
+  }
+
+  int NumVertices() const
+  {
+    if (IsCompressed())
+      return static_cast<int>(compressed_vertices_.size() / compressed_stride);
+    if (IsInterleaved())
+      return static_cast<int>(interleaved_vertices_.size() / interleaved_stride);
+    return static_cast<int>(vertices_.size() / 3);
+  }
+
+  AttributeView PositionView() const
+  {
+    if (IsInterleaved())
+      return AttributeView{ interleaved_vertices_.data(), interleaved_stride };
+    if (!vertices_.empty())
+      return AttributeView{ vertices_.data(), 3 };
+    return AttributeView{};
+  }
+
+  AttributeView NormalView() const
+  {
+    if (IsInterleaved())
+      return AttributeView{ interleaved_vertices_.data() + 3, interleaved_stride };
+    if (!normals_.empty())
+      return AttributeView{ normals_.data(), 3 };
+    return AttributeView{};
+  }
+
+  AttributeView TexCoordView() const
+  {
+    if (IsInterleaved())
+      return AttributeView{ interleaved_vertices_.data() + 6, interleaved_stride };
+    if (!tex_coords_.empty())
+      return AttributeView{ tex_coords_.data(), 2 };
+    return AttributeView{};
+  }
+
+  std::vector<float> Positions() const
+  {
+    const auto num_vertices = NumVertices();
+    std::vector<float> positions(static_cast<size_t>(num_vertices) * 3);
+
+    if (IsCompressed())
+    {
+      for (int i = 0; i < num_vertices; i++)
+      {
+        for (int j = 0; j < 3; j++)
+          positions[i * 3 + j] = position_offset_[j] + position_scale_[j] * compressed_vertices_[static_cast<size_t>(i) * compressed_stride + j] / 65535.f;
+      }
+    }
+    else
+    {
+      const auto view = PositionView();
+      for (int i = 0; i < num_vertices; i++)
+        std::copy_n(view[i], 3, positions.data() + i * 3);
+    }
+
+    return positions;
+  }
+
   const std::vector<uint32_t>& Indices() const
   {
     return indices_;
   }
 
-  const std::string& TextureFilepath() const
+  int NumTriangles() const
+  {
+    return static_cast<int>(indices_.size() / 3);
+  }
+
+  bool HasShortIndices() const
+  {
+    return has_short_indices_;
+  }
+
+  void CopyShortIndices(uint16_t* short_indices) const
   {
-    return texture_filepath_;
+    std::copy(indices_.begin(), indices_.end(), short_indices);
+  }
+
+  uint32_t TextureId(TextureSlot slot) const
+  {
+    return texture_ids_[static_cast<uint32_t>(slot)];
+  }
+
+  const std::vector<MeshLod>& Lods() const
+  {
+    return lods_;
+  }
+
+  const std::vector<Meshlet>& Meshlets() const
+  {
+    return meshlets_;
+  }
+
+  const MeshBounds& Bounds() const
+  {
+    return bounds_;
+  }
+
+  MeshBounds ComputeBounds() const
+  {
+    MeshBounds bounds;
+    const auto num_vertices = NumVertices();
+    if (num_vertices == 0)
+      return bounds;
+
+    // Quantized positions span the box exactly
+    if (IsCompressed())
+    {
+      for (int j = 0; j < 3; j++)
+      {
+        bounds.min[j] = position_offset_[j];
+        bounds.max[j] = position_offset_[j] + position_scale_[j];
+      }
+      const auto positions = Positions();
+      FinishBounds(positions.data(), 3, num_vertices, bounds);
+      return bounds;
+    }
+
+    const auto view = PositionView();
+    ComputeBox(view.data, view.stride, num_vertices, bounds);
+    FinishBounds(view.data, view.stride, num_vertices, bounds);
+    return bounds;
   }
 
 private:
+  static void ComputeBox(const float* positions, int stride, int num_vertices, MeshBounds& bounds)
+  {
+    int begin = 0;
+    std::array<float, 3> box_min{ positions[0], positions[1], positions[2] };
+    std::array<float, 3> box_max = box_min;
+
+#ifdef TWOPI_GEOMETRY_MESH_SSE2
+    if (stride == 3)
+    {
+      // Four packed xyz vertices per 12 floats: lanes of the three registers cycle through x, y, z
+      __m128 min0 = _mm_set1_ps(std::numeric_limits<float>::max());
+      __m128 min1 = min0;
+      __m128 min2 = min0;
+      __m128 max0 = _mm_set1_ps(std::numeric_limits<float>::lowest());
+      __m128 max1 = max0;
+      __m128 max2 = max0;
+
+      for (; begin + 4 <= num_vertices; begin += 4)
+      {
+        const auto* p = positions + static_cast<size_t>(begin) * 3;
+        const auto v0 = _mm_loadu_ps(p);
+        const auto v1 = _mm_loadu_ps(p + 4);
+        const auto v2 = _mm_loadu_ps(p + 8);
+        min0 = _mm_min_ps(min0, v0);
+        min1 = _mm_min_ps(min1, v1);
+        min2 = _mm_min_ps(min2, v2);
+        max0 = _mm_max_ps(max0, v0);
+        max1 = _mm_max_ps(max1, v1);
+        max2 = _mm_max_ps(max2, v2);
+      }
+
+      alignas(16) float mins[12];
+      alignas(16) float maxs[12];
+      _mm_store_ps(mins, min0);
+      _mm_store_ps(mins + 4, min1);
+      _mm_store_ps(mins + 8, min2);
+      _mm_store_ps(maxs, max0);
+      _mm_store_ps(maxs + 4, max1);
+      _mm_store_ps(maxs + 8, max2);
+      for (int i = 0; i < 12; i++)
+      {
+        box_min[i % 3] = std::min(box_min[i % 3], mins[i]);
+        box_max[i % 3] = std::max(box_max[i % 3], maxs[i]);
+      }
+    }
+    else if (stride >= 4)
+    {
+      // One vertex per register; the fourth lane is ignored
+      __m128 min = _mm_loadu_ps(positions);
+      __m128 max = min;
+      for (; begin < num_vertices; begin++)
+      {
+        const auto v = _mm_loadu_ps(positions + static_cast<size_t>(begin) * stride);
+        min = _mm_min_ps(min, v);
+        max = _mm_max_ps(max, v);
+      }
+
+      alignas(16) float mins[4];
+      alignas(16) float maxs[4];
+      _mm_store_ps(mins, min);
+      _mm_store_ps(maxs, max);
+      for (int j = 0; j < 3; j++)
+      {
+        box_min[j] = std::min(box_min[j], mins[j]);
+        box_max[j] = std::max(box_max[j], maxs[j]);
+      }
+    }
+#endif
+
+    for (int i = begin; i < num_vertices; i++)
+    {
+      const auto* p = positions + static_cast<size_t>(i) * stride;
+      for (int j = 0; j < 3; j++)
+      {
+        box_min[j] = std::min(box_min[j], p[j]);
+        box_max[j] = std::max(box_max[j], p[j]);
+      }
+    }
+
+    bounds.min = box_min;
+    bounds.max = box_max;
+  }
+
+  static void FinishBounds(const float* positions, int stride, int num_vertices, MeshBounds& bounds)
+  {
+    for (int j = 0; j < 3; j++)
+      bounds.center[j] = (bounds.min[j] + bounds.max[j]) * 0.5f;
+
+    int begin = 0;
+    float radius_squared = 0.f;
+
+#ifdef TWOPI_GEOMETRY_MESH_SSE2
+    {
+      // Loads read one float past the position, so the last packed vertex is left to the scalar loop
+      const auto end = stride > 3 ? num_vertices : num_vertices - 1;
+      const auto center = _mm_setr_ps(bounds.center[0], bounds.center[1], bounds.center[2], 0.f);
+      const auto mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+      __m128 max_distance = _mm_setzero_ps();
+      for (; begin < end; begin++)
+      {
+        const auto d = _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(positions + static_cast<size_t>(begin) * stride), center), mask);
+        const auto d2 = _mm_mul_ps(d, d);
+        // x + y + z into every lane
+        const auto sum = _mm_add_ps(d2, _mm_shuffle_ps(d2, d2, _MM_SHUFFLE(2, 3, 0, 1)));
+        max_distance = _mm_max_ps(max_distance, _mm_add_ps(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 0, 3, 2))));
+      }
+      radius_squared = _mm_cvtss_f32(max_distance);
+    }
+#endif
+
+    for (int i = begin; i < num_vertices; i++)
+    {
+      const auto* p = positions + static_cast<size_t>(i) * stride;
+      const auto dx = p[0] - bounds.center[0];
+      const auto dy = p[1] - bounds.center[1];
+      const auto dz = p[2] - bounds.center[2];
+      radius_squared = std::max(radius_squared, dx * dx + dy * dy + dz * dz);
+    }
+
+    bounds.radius = std::sqrt(radius_squared);
+  }
+
   std::vector<float> vertices_;
   std::vector<float> normals_;
   std::vector<float> tex_coords_;
+  std::vector<float> tangents_;
+  std::vector<float> interleaved_vertices_;
+  std::vector<uint16_t> compressed_vertices_;
+  std::array<float, 3> position_offset_{ 0.f, 0.f, 0.f };
+  std::array<float, 3> position_scale_{ 1.f, 1.f, 1.f };
+  // Levels of detail share the index buffer on the GPU, so they count too
+  void UpdateShortIndices()
+  {
+    const auto fits = [](const std::vector<uint32_t>& indices) {
+      return indices.empty() || *std::max_element(indices.begin(), indices.end()) < 65536;
+    };
+
+    has_short_indices_ = fits(indices_) && std::all_of(lods_.begin(), lods_.end(), [&fits](const MeshLod& lod) {
+      return fits(lod.indices);
+      });
+  }
+
   std::vector<uint32_t> indices_;
-  std::string texture_filepath_;
+  bool has_short_indices_ = true;
+  std::array<uint32_t, static_cast<uint32_t>(TextureSlot::NUM_TEXTURE_SLOTS)> texture_ids_{ TextureTable::invalid_id, TextureTable::invalid_id, TextureTable::invalid_id };
+  std::vector<MeshLod> lods_;
+  std::vector<Meshlet> meshlets_;
+  MeshBounds bounds_;
 };
 
 Mesh::Mesh()
@@ -93,14 +441,39 @@ void Mesh::SetTexCoords(std::vector<float>&& tex_coords)
   impl_->SetTexCoords(std::move(tex_coords));
 }
 
+void Mesh::SetTangents(std::vector<float>&& tangents)
+{
+  impl_->SetTangents(std::move(tangents));
+}
+
+void Mesh::SetInterleavedVertices(std::vector<float>&& interleaved_vertices)
+{
+  impl_->SetInterleavedVertices(std::move(interleaved_vertices));
+}
+
+void Mesh::SetCompressedVertices(std::vector<uint16_t>&& compressed_vertices)
+{
+  impl_->SetCompressedVertices(std::move(compressed_vertices));
+}
+
+void Mesh::SetPositionDequantization(const std::array<float, 3>& offset, const std::array<float, 3>& scale)
+{
+  impl_->SetPositionDequantization(offset, scale);
+}
+
 void Mesh::SetIndices(std::vector<uint32_t>&& indices)
 {
   impl_->SetIndices(std::move(indices));
 }
 
-void Mesh::SetTextureFilepath(std::string&& texture_filepath)
+void Mesh::SetIndices(const std::vector<uint16_t>& indices)
+{
+  impl_->SetIndices(indices);
+}
+
+void Mesh::SetTextureId(TextureSlot slot, uint32_t texture_id)
 {
-  impl_->SetTextureFilepath(std::move(texture_filepath));
+  impl_->SetTextureId(slot, texture_id);
 }
 
 const std::vector<float>& Mesh::Vertices() const
@@ -118,14 +491,124 @@ const std::vector<float>& Mesh::TexCoords() const
   return impl_->TexCoords();
 }
 
+const std::vector<float>& Mesh::Tangents() const
+{
+  return impl_->Tangents();
+}
+
+const std::vector<float>& Mesh::InterleavedVertices() const
+{
+  return impl_->InterleavedVertices();
+}
+
+bool Mesh::IsInterleaved() const
+{
+  return impl_->IsInterleaved();
+}
+
+const std::vector<uint16_t>& Mesh::CompressedVertices() const
+{
+  return impl_->CompressedVertices();
+}
+
+bool Mesh::IsCompressed() const
+{
+  return impl_->IsCompressed();
+}
+
+const std::array<float, 3>& Mesh::PositionOffset() const
+{
+  return impl_->PositionOffset();
+}
+
+const std::array<float, 3>& Mesh::PositionScale() const
+{
+  return impl_->PositionScale();
+}
+
+int Mesh::NumVertices() const
+{
+  return impl_->NumVertices();
+}
+
+AttributeView Mesh::PositionView() const
+{
+  return impl_->PositionView();
+}
+
+AttributeView Mesh::NormalView() const
+{
+  return impl_->NormalView();
+}
+
+AttributeView Mesh::TexCoordView() const
+{
+  return impl_->TexCoordView();
+}
+
+std::vector<float> Mesh::Positions() const
+{
+  return impl_->Positions();
+}
+
 const std::vector<uint32_t>& Mesh::Indices() const
 {
   return impl_->Indices();
 }
 
-const std::string& Mesh::TextureFilepath() const
+void Mesh::SetLods(std::vector<MeshLod>&& lods)
+{
+  impl_->SetLods(std::move(lods));
+}
+
+void Mesh::SetMeshlets(std::vector<Meshlet>&& meshlets)
+{
+  impl_->SetMeshlets(std::move(meshlets));
+}
+
+void Mesh::SetBounds(const MeshBounds& bounds)
+{
+  impl_->SetBounds(bounds);
+}
+
+int Mesh::NumTriangles() const
+{
+  return impl_->NumTriangles();
+}
+
+bool Mesh::HasShortIndices() const
+{
+  return impl_->HasShortIndices();
+}
+
+void Mesh::CopyShortIndices(uint16_t* short_indices) const
+{
+  impl_->CopyShortIndices(short_indices);
+}
+
+uint32_t Mesh::TextureId(TextureSlot slot) const
+{
+  return impl_->TextureId(slot);
+}
+
+const std::vector<MeshLod>& Mesh::Lods() const
+{
+  return impl_->Lods();
+}
+
+const MeshBounds& Mesh::Bounds() const
+{
+  return impl_->Bounds();
+}
+
+MeshBounds Mesh::ComputeBounds() const
+{
+  return impl_->ComputeBounds();
+}
+
+const std::vector<Meshlet>& Mesh::Meshlets() const
 {
-  return impl_->TextureFilepath();
+  return impl_->Meshlets();
 }
 }
 }
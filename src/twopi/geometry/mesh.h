@@ -1,16 +1,74 @@
 #ifndef TWOPI_GEOMETRY_MESH_H_
 #define TWOPI_GEOMETRY_MESH_H_
 
+#include <array>
 #include <memory>
 #include <vector>
-#include <string>
 
 namespace twopi
 {
 namespace geometry
 {
+// Strided read access to a float vertex attribute, independent of planar or interleaved storage
+struct AttributeView
+{
+  const float* data = nullptr;
+  int stride = 0;
+
+  const float* operator [] (int index) const { return data + static_cast<size_t>(index) * stride; }
+  explicit operator bool() const { return data != nullptr; }
+};
+
+// Object space axis aligned box, and a bounding sphere around its center
+struct MeshBounds
+{
+  std::array<float, 3> min{ 0.f, 0.f, 0.f };
+  std::array<float, 3> max{ 0.f, 0.f, 0.f };
+  std::array<float, 3> center{ 0.f, 0.f, 0.f };
+  float radius = -1.f;
+
+  bool IsEmpty() const { return radius < 0.f; }
+};
+
+// Simplified index buffer over the vertices of a mesh, with its object space geometric error
+struct MeshLod
+{
+  std::vector<uint32_t> indices;
+  float error = 0.f;
+};
+
+// Cluster of triangles occupying a contiguous range of Mesh::Indices(), with bounds for cluster culling.
+// The cluster is backfacing from every viewpoint p with dot(normalize(cone_apex - p), cone_axis) >= cone_cutoff.
+struct Meshlet
+{
+  uint32_t first_index = 0;
+  uint32_t num_indices = 0;
+  uint32_t num_vertices = 0;
+  std::array<float, 3> center{ 0.f, 0.f, 0.f };
+  float radius = 0.f;
+  std::array<float, 3> cone_apex{ 0.f, 0.f, 0.f };
+  std::array<float, 3> cone_axis{ 0.f, 0.f, 0.f };
+  float cone_cutoff = 1.f;
+};
+
+enum class TextureSlot : uint32_t
+{
+  DIFFUSE = 0,
+  SPECULAR,
+  NORMAL,
+  NUM_TEXTURE_SLOTS,
+};
+
 class Mesh
 {
+public:
+  // Interleaved vertex layout: position (3), normal (3), tex_coord (2)
+  static constexpr int interleaved_stride = 8;
+
+  // Compressed vertex layout in 16-bit elements:
+  // quantized position (unorm 4, w unused), octahedral normal (snorm 2), tex_coord (half 2)
+  static constexpr int compressed_stride = 8;
+
 public:
   Mesh();
   ~Mesh();
@@ -18,14 +76,61 @@ public:
   void SetVertices(std::vector<float>&& vertices);
   void SetNormals(std::vector<float>&& normals);
   void SetTexCoords(std::vector<float>&& tex_coords);
+  // Planar in every layout: xyz tangent and bitangent sign w per vertex
+  void SetTangents(std::vector<float>&& tangents);
+  void SetInterleavedVertices(std::vector<float>&& interleaved_vertices);
+  void SetCompressedVertices(std::vector<uint16_t>&& compressed_vertices);
+  void SetPositionDequantization(const std::array<float, 3>& offset, const std::array<float, 3>& scale);
   void SetIndices(std::vector<uint32_t>&& indices);
-  void SetTextureFilepath(std::string&& texture_filepath);
+  void SetIndices(const std::vector<uint16_t>& indices);
+  // Id in the TextureTable of the model, TextureTable::invalid_id if the slot is empty
+  void SetTextureId(TextureSlot slot, uint32_t texture_id);
+  void SetLods(std::vector<MeshLod>&& lods);
+  void SetMeshlets(std::vector<Meshlet>&& meshlets);
+  void SetBounds(const MeshBounds& bounds);
 
   const std::vector<float>& Vertices() const;
   const std::vector<float>& Normals() const;
   const std::vector<float>& TexCoords() const;
+  const std::vector<float>& Tangents() const;
+  const std::vector<float>& InterleavedVertices() const;
+  bool IsInterleaved() const;
+  const std::vector<uint16_t>& CompressedVertices() const;
+  bool IsCompressed() const;
+  // position = offset + scale * unorm(quantized position)
+  const std::array<float, 3>& PositionOffset() const;
+  const std::array<float, 3>& PositionScale() const;
+  int NumVertices() const;
+
+  // Float attribute views; empty for compressed meshes or missing attributes
+  AttributeView PositionView() const;
+  AttributeView NormalView() const;
+  AttributeView TexCoordView() const;
+
+  // Object space positions (3 floats per vertex), dequantized for compressed meshes
+  std::vector<float> Positions() const;
+
   const std::vector<uint32_t>& Indices() const;
-  const std::string& TextureFilepath() const;
+  int NumTriangles() const;
+  // True if every index, including those of Lods(), fits in 16 bits, so that uploads and caches can halve index
+  // memory. The only test for 16-bit indices; GPU index buffers follow it.
+  bool HasShortIndices() const;
+
+  // Writes Indices() narrowed to 16 bits, e.g. into mapped staging memory. Requires HasShortIndices().
+  void CopyShortIndices(uint16_t* short_indices) const;
+  uint32_t TextureId(TextureSlot slot) const;
+
+  // Levels of detail from finer to coarser, excluding the full resolution Indices()
+  const std::vector<MeshLod>& Lods() const;
+
+  // Stored bounds, empty until SetBounds; the loader sets them for every imported mesh
+  const MeshBounds& Bounds() const;
+
+  // Bounds of the current positions, vectorized with SSE2 where available
+  MeshBounds ComputeBounds() const;
+
+  // Clusters covering the full resolution Indices() in order; empty if not partitioned
+  const std::vector<Meshlet>& Meshlets() const;
 
 private:
   class Impl;
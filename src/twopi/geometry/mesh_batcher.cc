@@ -0,0 +1,199 @@
+#include <twopi/geometry/mesh_batcher.h>
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <tuple>
+
+#include <twopi/geometry/mesh.h>
+
+namespace twopi
+{
+namespace geometry
+{
+namespace
+{
+constexpr auto num_texture_slots = static_cast<size_t>(TextureSlot::NUM_TEXTURE_SLOTS);
+
+// Meshes with equal keys are drawn with the same pipeline and textures
+struct BatchKey
+{
+  std::array<uint32_t, num_texture_slots> texture_ids{};
+  bool interleaved = false;
+  bool has_normals = false;
+  bool has_tex_coords = false;
+  bool has_tangents = false;
+
+  bool operator < (const BatchKey& rhs) const
+  {
+    return std::tie(texture_ids, interleaved, has_normals, has_tex_coords, has_tangents) <
+      std::tie(rhs.texture_ids, rhs.interleaved, rhs.has_normals, rhs.has_tex_coords, rhs.has_tangents);
+  }
+};
+
+BatchKey MakeKey(const Mesh& mesh)
+{
+  BatchKey key;
+  for (size_t slot = 0; slot < num_texture_slots; slot++)
+    key.texture_ids[slot] = mesh.TextureId(static_cast<TextureSlot>(slot));
+  key.interleaved = mesh.IsInterleaved();
+  key.has_normals = !mesh.Normals().empty();
+  key.has_tex_coords = !mesh.TexCoords().empty();
+  key.has_tangents = !mesh.Tangents().empty();
+  return key;
+}
+
+template <typename T>
+void Append(std::vector<T>& dst, const std::vector<T>& src)
+{
+  dst.insert(dst.end(), src.begin(), src.end());
+}
+}
+
+class MeshBatcher::Impl
+{
+public:
+  Impl()
+  {
+  }
+
+  ~Impl() = default;
+
+  void SetMaxVertices(int max_vertices)
+  {
+    max_vertices_ = std::max(max_vertices, 1);
+  }
+
+  std::vector<std::shared_ptr<Mesh>> Batch(const std::vector<std::shared_ptr<Mesh>>& meshes) const
+  {
+    // Group indices, in order of first occurrence; unbatchable meshes are groups of their own
+    std::vector<std::vector<size_t>> groups;
+    std::map<BatchKey, size_t> group_indices;
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+      const auto& mesh = *meshes[i];
+      if (mesh.IsCompressed() || mesh.Indices().empty() || mesh.NumVertices() > max_vertices_)
+      {
+        groups.push_back({ i });
+        continue;
+      }
+
+      const auto inserted = group_indices.emplace(MakeKey(mesh), groups.size());
+      if (inserted.second)
+        groups.emplace_back();
+      groups[inserted.first->second].push_back(i);
+    }
+
+    std::vector<std::shared_ptr<Mesh>> batches;
+    for (const auto& group : groups)
+    {
+      // Fill batches greedily up to the vertex limit, keeping the input order
+      size_t begin = 0;
+      while (begin < group.size())
+      {
+        auto end = begin + 1;
+        auto num_vertices = static_cast<size_t>(meshes[group[begin]]->NumVertices());
+        while (end < group.size() && num_vertices + meshes[group[end]]->NumVertices() <= static_cast<size_t>(max_vertices_))
+          num_vertices += meshes[group[end++]]->NumVertices();
+
+        if (end - begin == 1)
+          batches.push_back(meshes[group[begin]]);
+        else
+          batches.push_back(Merge(meshes, group.data() + begin, group.data() + end));
+        begin = end;
+      }
+    }
+
+    return batches;
+  }
+
+private:
+  static std::shared_ptr<Mesh> Merge(const std::vector<std::shared_ptr<Mesh>>& meshes, const size_t* first, const size_t* last)
+  {
+    std::vector<float> vertices;
+    std::vector<float> normals;
+    std::vector<float> tex_coords;
+    std::vector<float> tangents;
+    std::vector<float> interleaved_vertices;
+    std::vector<uint32_t> indices;
+
+    size_t total_vertices = 0;
+    size_t total_indices = 0;
+    for (auto it = first; it != last; ++it)
+    {
+      total_vertices += meshes[*it]->NumVertices();
+      total_indices += meshes[*it]->Indices().size();
+    }
+    indices.reserve(total_indices);
+
+    const auto& front = *meshes[*first];
+    if (front.IsInterleaved())
+      interleaved_vertices.reserve(total_vertices * Mesh::interleaved_stride);
+    else
+    {
+      vertices.reserve(total_vertices * 3);
+      normals.reserve(front.Normals().empty() ? 0 : total_vertices * 3);
+      tex_coords.reserve(front.TexCoords().empty() ? 0 : total_vertices * 2);
+    }
+    tangents.reserve(front.Tangents().empty() ? 0 : total_vertices * 4);
+
+    // Indices are rebased onto the concatenated vertices
+    uint32_t base_vertex = 0;
+    for (auto it = first; it != last; ++it)
+    {
+      const auto& mesh = *meshes[*it];
+      if (mesh.IsInterleaved())
+        Append(interleaved_vertices, mesh.InterleavedVertices());
+      else
+      {
+        Append(vertices, mesh.Vertices());
+        Append(normals, mesh.Normals());
+        Append(tex_coords, mesh.TexCoords());
+      }
+      Append(tangents, mesh.Tangents());
+
+      for (auto index : mesh.Indices())
+        indices.push_back(base_vertex + index);
+      base_vertex += mesh.NumVertices();
+    }
+
+    auto batch = std::make_shared<Mesh>();
+    if (front.IsInterleaved())
+      batch->SetInterleavedVertices(std::move(interleaved_vertices));
+    else
+    {
+      batch->SetVertices(std::move(vertices));
+      batch->SetNormals(std::move(normals));
+      batch->SetTexCoords(std::move(tex_coords));
+    }
+    batch->SetTangents(std::move(tangents));
+    batch->SetIndices(std::move(indices));
+
+    for (size_t slot = 0; slot < num_texture_slots; slot++)
+      batch->SetTextureId(static_cast<TextureSlot>(slot), front.TextureId(static_cast<TextureSlot>(slot)));
+
+    batch->SetBounds(batch->ComputeBounds());
+    return batch;
+  }
+
+  int max_vertices_ = 65535;
+};
+
+MeshBatcher::MeshBatcher()
+{
+  impl_ = std::make_unique<Impl>();
+}
+
+MeshBatcher::~MeshBatcher() = default;
+
+void MeshBatcher::SetMaxVertices(int max_vertices)
+{
+  impl_->SetMaxVertices(max_vertices);
+}
+
+std::vector<std::shared_ptr<Mesh>> MeshBatcher::Batch(const std::vector<std::shared_ptr<Mesh>>& meshes) const
+{
+  return impl_->Batch(meshes);
+}
+}
+}
@@ -0,0 +1,37 @@
+#ifndef TWOPI_GEOMETRY_MESH_BATCHER_H_
+#define TWOPI_GEOMETRY_MESH_BATCHER_H_
+
+#include <memory>
+#include <vector>
+
+namespace twopi
+{
+namespace geometry
+{
+class Mesh;
+
+// Merges static meshes that share textures and vertex layout into one vertex and index buffer each,
+// so that a batch is drawn with a single draw call. Meshes must already be in a common space,
+// e.g. with node transforms baked in as MeshLoader does.
+class MeshBatcher
+{
+public:
+  MeshBatcher();
+  ~MeshBatcher();
+
+  // Maximum number of vertices per batch, 65535 by default so that batches keep 16-bit indices in VertexBuffer
+  void SetMaxVertices(int max_vertices);
+
+  // Batches in order of first occurrence of each material. Compressed and non-indexed meshes, and meshes
+  // alone in their batch, are returned as they are. Merged meshes drop Mesh::Lods and Mesh::Meshlets,
+  // so batching should run before generating them.
+  std::vector<std::shared_ptr<Mesh>> Batch(const std::vector<std::shared_ptr<Mesh>>& meshes) const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+}
+}
+
+#endif // TWOPI_GEOMETRY_MESH_BATCHER_H_
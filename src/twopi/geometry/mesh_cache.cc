@@ -0,0 +1,461 @@
+#include <twopi/geometry/mesh_cache.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <type_traits>
+
+#include <twopi/core/mapped_file.h>
+#include <twopi/geometry/mesh.h>
+#include <twopi/geometry/model.h>
+#include <twopi/geometry/texture_table.h>
+
+namespace twopi
+{
+namespace geometry
+{
+namespace
+{
+constexpr char magic[8] = { 'T', 'P', 'M', 'E', 'S', 'H', '\0', '\0' };
+constexpr uint64_t section_alignment = 16;
+constexpr auto num_sections = static_cast<uint32_t>(MeshCache::Section::NUM_SECTIONS);
+constexpr auto num_texture_slots = static_cast<uint32_t>(TextureSlot::NUM_TEXTURE_SLOTS);
+
+static_assert(std::is_trivially_copyable<Meshlet>::value, "Meshlets are stored as raw bytes");
+static_assert(std::is_trivially_copyable<MeshBounds>::value, "Bounds are stored as raw bytes");
+
+struct FileHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t num_meshes;
+  uint64_t import_flags;
+  int64_t source_mtime;
+  uint64_t source_filepath_size;
+};
+
+struct SectionEntry
+{
+  uint32_t section;
+  uint32_t reserved;
+  uint64_t offset;
+  uint64_t size;
+};
+
+uint64_t Align(uint64_t offset, uint64_t alignment)
+{
+  return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+int64_t SourceModificationTime(const std::string& filepath)
+{
+  std::error_code error;
+  const auto time = std::filesystem::last_write_time(filepath, error);
+  if (error)
+    return 0;
+  return static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+// FNV-1a
+uint64_t Hash(const void* data, size_t size, uint64_t hash = 14695981039346656037ull)
+{
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; i++)
+  {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+template <typename T>
+std::pair<const void*, uint64_t> SectionData(const std::vector<T>& data)
+{
+  return { data.data(), data.size() * sizeof(T) };
+}
+
+std::pair<const void*, uint64_t> SectionData(const Mesh& mesh, MeshCache::Section section)
+{
+  switch (section)
+  {
+  case MeshCache::Section::VERTICES: return SectionData(mesh.Vertices());
+  case MeshCache::Section::NORMALS: return SectionData(mesh.Normals());
+  case MeshCache::Section::TEX_COORDS: return SectionData(mesh.TexCoords());
+  case MeshCache::Section::TANGENTS: return SectionData(mesh.Tangents());
+  case MeshCache::Section::INTERLEAVED_VERTICES: return SectionData(mesh.InterleavedVertices());
+  case MeshCache::Section::INDICES: return SectionData(mesh.Indices());
+  case MeshCache::Section::COMPRESSED_VERTICES: return SectionData(mesh.CompressedVertices());
+  case MeshCache::Section::MESHLETS: return SectionData(mesh.Meshlets());
+  default: return { nullptr, 0 };
+  }
+}
+
+template <typename T>
+std::vector<T> ToVector(const MeshCache::View& view, int mesh_index, MeshCache::Section section)
+{
+  const auto* data = view.Data<T>(mesh_index, section);
+  return std::vector<T>(data, data + view.Count<T>(mesh_index, section));
+}
+}
+
+MeshCache::View::View(std::shared_ptr<core::MappedFile> file, std::vector<std::vector<SectionRange>>&& sections)
+  : file_(std::move(file))
+  , sections_(std::move(sections))
+{
+}
+
+MeshCache::View::~View() = default;
+
+int MeshCache::View::NumMeshes() const
+{
+  return static_cast<int>(sections_.size());
+}
+
+const void* MeshCache::View::Data(int mesh_index, Section section) const
+{
+  const auto& range = sections_[mesh_index][static_cast<uint32_t>(section)];
+  return static_cast<const char*>(file_->Data()) + range.offset;
+}
+
+uint64_t MeshCache::View::Size(int mesh_index, Section section) const
+{
+  return sections_[mesh_index][static_cast<uint32_t>(section)].size;
+}
+
+class MeshCache::Impl
+{
+public:
+  Impl() = delete;
+
+  explicit Impl(const std::string& dirpath)
+    : dirpath_(dirpath)
+  {
+  }
+
+  ~Impl() = default;
+
+  std::string CacheFilepath(const std::string& source_filepath, uint64_t import_flags) const
+  {
+    auto hash = Hash(source_filepath.data(), source_filepath.size());
+    hash = Hash(&import_flags, sizeof import_flags, hash);
+
+    char filename[32];
+    std::snprintf(filename, sizeof filename, "%016llx.tpmesh", static_cast<unsigned long long>(hash));
+    return dirpath_ + '/' + filename;
+  }
+
+  std::shared_ptr<View> Map(const std::string& source_filepath, uint64_t import_flags) const
+  {
+    const auto cache_filepath = CacheFilepath(source_filepath, import_flags);
+
+    std::error_code error;
+    if (!std::filesystem::exists(cache_filepath, error))
+      return nullptr;
+
+    auto file = std::make_shared<core::MappedFile>(cache_filepath);
+    const auto* data = static_cast<const char*>(file->Data());
+    const auto file_size = static_cast<uint64_t>(file->Size());
+
+    // Validate header against the source asset
+    if (file_size < sizeof(FileHeader))
+      return nullptr;
+
+    FileHeader header;
+    std::memcpy(&header, data, sizeof header);
+    if (std::memcmp(header.magic, magic, sizeof magic) != 0 ||
+      header.version != version ||
+      header.import_flags != import_flags ||
+      header.source_mtime != SourceModificationTime(source_filepath) ||
+      header.source_filepath_size != source_filepath.size() ||
+      sizeof(FileHeader) + header.source_filepath_size > file_size ||
+      std::memcmp(data + sizeof(FileHeader), source_filepath.data(), source_filepath.size()) != 0)
+      return nullptr;
+
+    // Section tables
+    uint64_t offset = Align(sizeof(FileHeader) + header.source_filepath_size, section_alignment);
+    const uint64_t table_size = static_cast<uint64_t>(header.num_meshes) * num_sections * sizeof(SectionEntry);
+    if (offset + table_size > file_size)
+      return nullptr;
+
+    std::vector<std::vector<View::SectionRange>> sections(header.num_meshes, std::vector<View::SectionRange>(num_sections));
+    for (uint32_t i = 0; i < header.num_meshes; i++)
+    {
+      for (uint32_t j = 0; j < num_sections; j++)
+      {
+        SectionEntry entry;
+        std::memcpy(&entry, data + offset, sizeof entry);
+        offset += sizeof entry;
+
+        // Compared without summing, so that corrupt offsets cannot wrap around
+        if (entry.section >= num_sections || entry.size > file_size || entry.offset > file_size - entry.size)
+          return nullptr;
+
+        sections[i][entry.section].offset = entry.offset;
+        sections[i][entry.section].size = entry.size;
+      }
+
+      // Level ranges must lie within LOD_INDICES, for uploads straight from the mapping as well as Load
+      const auto& lod_table = sections[i][static_cast<uint32_t>(Section::LOD_TABLE)];
+      const auto& lod_indices = sections[i][static_cast<uint32_t>(Section::LOD_INDICES)];
+      uint64_t num_lod_indices = 0;
+      for (uint64_t j = 0; j < lod_table.size / sizeof(LodEntry); j++)
+      {
+        LodEntry lod_entry;
+        std::memcpy(&lod_entry, data + lod_table.offset + j * sizeof(LodEntry), sizeof lod_entry);
+        num_lod_indices += lod_entry.num_indices;
+      }
+      if (num_lod_indices > lod_indices.size / sizeof(uint32_t))
+        return nullptr;
+
+      if (sections[i][static_cast<uint32_t>(Section::BOUNDS)].size != sizeof(MeshBounds))
+        return nullptr;
+    }
+
+    return std::make_shared<View>(std::move(file), std::move(sections));
+  }
+
+  std::shared_ptr<Model> Load(const std::string& source_filepath, uint64_t import_flags, std::shared_ptr<TextureTable> textures) const
+  {
+    const auto view = Map(source_filepath, import_flags);
+    if (view == nullptr)
+      return nullptr;
+
+    std::vector<std::shared_ptr<Mesh>> meshes;
+    for (int i = 0; i < view->NumMeshes(); i++)
+    {
+      auto mesh = std::make_shared<Mesh>();
+      mesh->SetVertices(ToVector<float>(*view, i, Section::VERTICES));
+      mesh->SetNormals(ToVector<float>(*view, i, Section::NORMALS));
+      mesh->SetTexCoords(ToVector<float>(*view, i, Section::TEX_COORDS));
+      mesh->SetTangents(ToVector<float>(*view, i, Section::TANGENTS));
+      mesh->SetInterleavedVertices(ToVector<float>(*view, i, Section::INTERLEAVED_VERTICES));
+
+      // Meshes with short indices store them in SHORT_INDICES instead of INDICES
+      if (view->Size(i, Section::SHORT_INDICES) > 0)
+        mesh->SetIndices(ToVector<uint16_t>(*view, i, Section::SHORT_INDICES));
+      else
+        mesh->SetIndices(ToVector<uint32_t>(*view, i, Section::INDICES));
+
+      // One null terminated filepath per texture slot, empty for no texture
+      const auto* texture_filepath = view->Data<char>(i, Section::TEXTURE_FILEPATHS);
+      const auto* texture_filepaths_end = texture_filepath + view->Size(i, Section::TEXTURE_FILEPATHS);
+      for (uint32_t slot = 0; slot < num_texture_slots && texture_filepath < texture_filepaths_end; slot++)
+      {
+        const std::string filepath(texture_filepath, std::find(texture_filepath, texture_filepaths_end, '\0'));
+        if (!filepath.empty())
+          mesh->SetTextureId(static_cast<TextureSlot>(slot), textures->Intern(filepath));
+        texture_filepath += filepath.size() + 1;
+      }
+
+      mesh->SetCompressedVertices(ToVector<uint16_t>(*view, i, Section::COMPRESSED_VERTICES));
+      if (view->Count<float>(i, Section::POSITION_DEQUANTIZATION) == 6)
+      {
+        const auto* dequantization = view->Data<float>(i, Section::POSITION_DEQUANTIZATION);
+        mesh->SetPositionDequantization(
+          { dequantization[0], dequantization[1], dequantization[2] },
+          { dequantization[3], dequantization[4], dequantization[5] });
+      }
+
+      const auto* lod_entries = view->Data<LodEntry>(i, Section::LOD_TABLE);
+      const auto* lod_indices = view->Data<uint32_t>(i, Section::LOD_INDICES);
+      std::vector<MeshLod> lods(view->Count<LodEntry>(i, Section::LOD_TABLE));
+      for (auto& lod : lods)
+      {
+        lod.indices.assign(lod_indices, lod_indices + lod_entries->num_indices);
+        lod.error = lod_entries->error;
+        lod_indices += lod_entries->num_indices;
+        lod_entries++;
+      }
+      mesh->SetLods(std::move(lods));
+
+      mesh->SetMeshlets(ToVector<Meshlet>(*view, i, Section::MESHLETS));
+      mesh->SetBounds(*view->Data<MeshBounds>(i, Section::BOUNDS));
+
+      meshes.emplace_back(std::move(mesh));
+    }
+
+    auto model = std::make_shared<Model>();
+    model->SetMeshes(std::move(meshes));
+    model->SetTextures(std::move(textures));
+    return model;
+  }
+
+  bool Save(const std::string& source_filepath, uint64_t import_flags, const Model& model) const
+  {
+    std::error_code error;
+    std::filesystem::create_directories(dirpath_, error);
+
+    const auto& meshes = model.Meshes();
+
+    FileHeader header;
+    std::memcpy(header.magic, magic, sizeof magic);
+    header.version = version;
+    header.num_meshes = static_cast<uint32_t>(meshes.size());
+    header.import_flags = import_flags;
+    header.source_mtime = SourceModificationTime(source_filepath);
+    header.source_filepath_size = source_filepath.size();
+
+    // Lay out section data after the header and section tables
+    const uint64_t table_offset = Align(sizeof(FileHeader) + source_filepath.size(), section_alignment);
+    uint64_t offset = table_offset + meshes.size() * num_sections * sizeof(SectionEntry);
+
+    // Sections that are not stored contiguously in Mesh are packed here; reserved so pointers stay valid
+    std::vector<std::array<float, 6>> dequantizations;
+    dequantizations.reserve(meshes.size());
+    std::vector<std::vector<uint16_t>> short_indices;
+    short_indices.reserve(meshes.size());
+    std::vector<MeshBounds> bounds;
+    bounds.reserve(meshes.size());
+    std::vector<std::string> texture_filepaths(meshes.size());
+    std::vector<std::vector<uint32_t>> lod_indices(meshes.size());
+    std::vector<std::vector<LodEntry>> lod_entries(meshes.size());
+
+    std::vector<SectionEntry> entries;
+    std::vector<std::pair<const void*, uint64_t>> section_data;
+    for (int i = 0; i < meshes.size(); i++)
+    {
+      const auto& mesh = meshes[i];
+      for (const auto& lod : mesh->Lods())
+      {
+        lod_indices[i].insert(lod_indices[i].end(), lod.indices.begin(), lod.indices.end());
+        lod_entries[i].push_back({ static_cast<uint32_t>(lod.indices.size()), lod.error });
+      }
+
+      for (uint32_t slot = 0; slot < num_texture_slots; slot++)
+      {
+        const auto texture_id = mesh->TextureId(static_cast<TextureSlot>(slot));
+        if (texture_id != TextureTable::invalid_id && model.Textures() != nullptr)
+          texture_filepaths[i] += model.Textures()->Filepath(texture_id);
+        texture_filepaths[i] += '\0';
+      }
+
+      const auto& position_offset = mesh->PositionOffset();
+      const auto& position_scale = mesh->PositionScale();
+      dequantizations.push_back({
+        position_offset[0], position_offset[1], position_offset[2],
+        position_scale[0], position_scale[1], position_scale[2] });
+
+      // Stored bounds are never empty, so that meshes uploaded from the mapping can be culled
+      bounds.push_back(mesh->Bounds().IsEmpty() ? mesh->ComputeBounds() : mesh->Bounds());
+
+      const auto has_short_indices = mesh->HasShortIndices();
+      if (has_short_indices)
+      {
+        short_indices.emplace_back(mesh->Indices().size());
+        mesh->CopyShortIndices(short_indices.back().data());
+      }
+
+      for (uint32_t j = 0; j < num_sections; j++)
+      {
+        const auto section = static_cast<Section>(j);
+        auto data = SectionData(*mesh, section);
+        if (section == Section::POSITION_DEQUANTIZATION && mesh->IsCompressed())
+          data = { dequantizations.back().data(), sizeof(float) * 6 };
+        else if (section == Section::INDICES && has_short_indices)
+          data = { nullptr, 0 };
+        else if (section == Section::SHORT_INDICES && has_short_indices)
+          data = SectionData(short_indices.back());
+        else if (section == Section::BOUNDS)
+          data = { &bounds.back(), sizeof(MeshBounds) };
+        else if (section == Section::TEXTURE_FILEPATHS)
+          data = { texture_filepaths[i].data(), texture_filepaths[i].size() };
+        else if (section == Section::LOD_INDICES)
+          data = SectionData(lod_indices[i]);
+        else if (section == Section::LOD_TABLE)
+          data = SectionData(lod_entries[i]);
+
+        offset = Align(offset, section_alignment);
+
+        SectionEntry entry;
+        entry.section = j;
+        entry.reserved = 0;
+        entry.offset = offset;
+        entry.size = data.second;
+        entries.push_back(entry);
+        section_data.push_back(data);
+
+        offset += data.second;
+      }
+    }
+
+    // Write to a temporary file first, so that a partially written cache is never mapped
+    const auto cache_filepath = CacheFilepath(source_filepath, import_flags);
+    // Per thread, since asynchronous loads of the same source may save concurrently
+    const auto temp_filepath = cache_filepath + ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+      std::ofstream out(temp_filepath, std::ios::binary | std::ios::trunc);
+      if (!out.is_open())
+        return false;
+
+      const char zeros[section_alignment] = {};
+      const auto pad_to = [&out, &zeros](uint64_t position) {
+        const auto current = static_cast<uint64_t>(out.tellp());
+        out.write(zeros, position - current);
+      };
+
+      out.write(reinterpret_cast<const char*>(&header), sizeof header);
+      out.write(source_filepath.data(), source_filepath.size());
+      pad_to(table_offset);
+      out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(SectionEntry));
+
+      for (int i = 0; i < entries.size(); i++)
+      {
+        pad_to(entries[i].offset);
+        out.write(static_cast<const char*>(section_data[i].first), section_data[i].second);
+      }
+
+      out.close();
+      if (!out)
+      {
+        std::filesystem::remove(temp_filepath, error);
+        return false;
+      }
+    }
+
+    // Replacing may fail while another view still maps the old file; the cache is then refreshed on a later save
+    std::filesystem::rename(temp_filepath, cache_filepath, error);
+    if (error)
+    {
+      std::filesystem::remove(temp_filepath, error);
+      return false;
+    }
+    return true;
+  }
+
+private:
+  std::string dirpath_;
+};
+
+MeshCache::MeshCache(const std::string& dirpath)
+{
+  impl_ = std::make_unique<Impl>(dirpath);
+}
+
+MeshCache::~MeshCache() = default;
+
+std::string MeshCache::CacheFilepath(const std::string& source_filepath, uint64_t import_flags) const
+{
+  return impl_->CacheFilepath(source_filepath, import_flags);
+}
+
+std::shared_ptr<MeshCache::View> MeshCache::Map(const std::string& source_filepath, uint64_t import_flags) const
+{
+  return impl_->Map(source_filepath, import_flags);
+}
+
+std::shared_ptr<Model> MeshCache::Load(const std::string& source_filepath, uint64_t import_flags, std::shared_ptr<TextureTable> textures) const
+{
+  return impl_->Load(source_filepath, import_flags, std::move(textures));
+}
+
+bool MeshCache::Save(const std::string& source_filepath, uint64_t import_flags, const Model& model) const
+{
+  return impl_->Save(source_filepath, import_flags, model);
+}
+}
+}
@@ -0,0 +1,114 @@
+#ifndef TWOPI_GEOMETRY_MESH_CACHE_H_
+#define TWOPI_GEOMETRY_MESH_CACHE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace twopi
+{
+namespace core
+{
+class MappedFile;
+}
+
+namespace geometry
+{
+class Model;
+class TextureTable;
+
+// Versioned binary cache (.tpmesh) of loaded models, keyed by source path, modification time and import flags
+class MeshCache
+{
+public:
+  static constexpr uint32_t version = 9;
+
+  enum class Section : uint32_t
+  {
+    VERTICES = 0,
+    NORMALS,
+    TEX_COORDS,
+    INTERLEAVED_VERTICES,
+    INDICES,
+    TEXTURE_FILEPATHS,
+    COMPRESSED_VERTICES,
+    POSITION_DEQUANTIZATION,
+    SHORT_INDICES,
+    LOD_INDICES,
+    LOD_TABLE,
+    MESHLETS,
+    BOUNDS,
+    TANGENTS,
+    NUM_SECTIONS,
+  };
+
+  // Levels of detail are concatenated in LOD_INDICES, one entry per level in LOD_TABLE
+  struct LodEntry
+  {
+    uint32_t num_indices;
+    float error;
+  };
+
+  // View of a memory mapped cache file. Section data points directly into the mapping, e.g. for uploads to the
+  // GPU without intermediate copies; Load copies it out, since meshes own their arrays. Map has checked that
+  // level of detail ranges lie within LOD_INDICES and that every mesh has BOUNDS.
+  class View
+  {
+  public:
+    struct SectionRange
+    {
+      uint64_t offset = 0;
+      uint64_t size = 0;
+    };
+
+  public:
+    View() = delete;
+    View(std::shared_ptr<core::MappedFile> file, std::vector<std::vector<SectionRange>>&& sections);
+    ~View();
+
+    int NumMeshes() const;
+    const void* Data(int mesh_index, Section section) const;
+    uint64_t Size(int mesh_index, Section section) const;
+
+    template <typename T>
+    const T* Data(int mesh_index, Section section) const
+    {
+      return static_cast<const T*>(Data(mesh_index, section));
+    }
+
+    template <typename T>
+    uint64_t Count(int mesh_index, Section section) const
+    {
+      return Size(mesh_index, section) / sizeof(T);
+    }
+
+  private:
+    std::shared_ptr<core::MappedFile> file_;
+    std::vector<std::vector<SectionRange>> sections_;
+  };
+
+public:
+  MeshCache() = delete;
+  explicit MeshCache(const std::string& dirpath);
+  ~MeshCache();
+
+  std::string CacheFilepath(const std::string& source_filepath, uint64_t import_flags) const;
+
+  // Returns nullptr if the cache file does not exist or is stale
+  std::shared_ptr<View> Map(const std::string& source_filepath, uint64_t import_flags) const;
+  // Texture filepaths are stored per mesh and interned into textures on load
+  std::shared_ptr<Model> Load(const std::string& source_filepath, uint64_t import_flags, std::shared_ptr<TextureTable> textures) const;
+
+  // Best effort: returns false, leaving no temporary file behind, if the cache cannot be written,
+  // e.g. to a read-only directory or a full disk
+  bool Save(const std::string& source_filepath, uint64_t import_flags, const Model& model) const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+}
+}
+
+#endif // TWOPI_GEOMETRY_MESH_CACHE_H_
@@ -1,13 +1,27 @@
 #include <twopi/geometry/mesh_loader.h>
 
+#include <algorithm>
+#include <mutex>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+#include <twopi/core/thread_pool.h>
 #include <twopi/geometry/mesh.h>
+#include <twopi/geometry/mesh_batcher.h>
+#include <twopi/geometry/mesh_cache.h>
+#include <twopi/geometry/mesh_optimizer.h>
+#include <twopi/geometry/mesh_simplifier.h>
+#include <twopi/geometry/mesh_welder.h>
+#include <twopi/geometry/meshlet_builder.h>
+#include <twopi/geometry/model.h>
+#include <twopi/geometry/tangent_generator.h>
+#include <twopi/geometry/texture_table.h>
+#include <twopi/geometry/vertex_compressor.h>
 
 namespace twopi
 {
@@ -17,129 +31,453 @@ class MeshLoader::Impl
 {
 public:
   Impl()
+    : own_thread_pool_(std::make_unique<core::ThreadPool>())
+    , thread_pool_(*own_thread_pool_)
+    , welder_(thread_pool_)
+    , optimizer_(thread_pool_)
+    , tangent_generator_(thread_pool_)
   {
+    textures_ = std::make_shared<TextureTable>();
+  }
+
+  explicit Impl(core::ThreadPool& thread_pool)
+    : thread_pool_(thread_pool)
+    , welder_(thread_pool_)
+    , optimizer_(thread_pool_)
+    , tangent_generator_(thread_pool_)
+  {
+    textures_ = std::make_shared<TextureTable>();
   }
 
   ~Impl() = default;
 
-  std::shared_ptr<Mesh> Load(const std::string& filepath)
+  std::shared_ptr<Model> Load(const std::string& filepath)
   {
+    const auto import_flags = ImportFlags();
+
+    // Warm start from binary cache
+    if (cache_ != nullptr)
+    {
+      auto model = cache_->Load(filepath, import_flags, textures_);
+      if (model != nullptr)
+      {
+        // Nothing was optimized or generated for this load
+        std::lock_guard<std::mutex> lock(statistics_mutex_);
+        optimization_statistics_ = MeshOptimizer::Statistics{};
+        tangent_space_duration_ = core::Duration{ 0. };
+        return model;
+      }
+    }
+
     Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(filepath, aiProcess_Triangulate);
+    const aiScene* scene = importer.ReadFile(filepath, AssimpFlags());
 
     if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
       throw std::runtime_error(importer.GetErrorString());
 
-    dirpath_ = filepath.substr(0, filepath.find_last_of('/'));
+    // Assimp tangent space runs as a separate post process step, so that it is timed alone
+    core::Duration tangent_space_duration{ 0. };
+    if (generate_tangent_space_ && assimp_tangent_space_)
+    {
+      const auto start = core::Clock::now();
+      scene = importer.ApplyPostProcessing(aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace);
+      tangent_space_duration = core::Clock::now() - start;
 
-    return ProcessNode(scene->mRootNode, scene);
-  }
+      if (!scene)
+        throw std::runtime_error(importer.GetErrorString());
+    }
 
-private:
-  std::shared_ptr<Mesh> ProcessNode(aiNode* node, const aiScene* scene)
-  {
-    for (unsigned int i = 0; i < node->mNumMeshes; i++)
+    const auto dirpath = filepath.substr(0, filepath.find_last_of('/'));
+
+    // Collect every mesh instance in the node tree with its accumulated transform
+    std::vector<std::pair<const aiMesh*, aiMatrix4x4>> mesh_instances;
+    ProcessNode(scene->mRootNode, aiMatrix4x4{}, scene, mesh_instances);
+
+    // Convert meshes in parallel. The importer owns the scene, so all tasks finish before returning.
+    std::vector<std::shared_ptr<Mesh>> meshes(mesh_instances.size());
+    std::vector<MeshOptimizer::Statistics> mesh_statistics(mesh_instances.size());
+    thread_pool_.ParallelFor(mesh_instances.size(), [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++)
+      {
+        meshes[i] = ProcessMesh(mesh_instances[i].first, mesh_instances[i].second, scene, dirpath);
+
+        if (weld_vertices_)
+          welder_.Weld(*meshes[i]);
+      }
+      });
+
+    // One mesh at a time, each parallelized inside the generator, so that a single large mesh still scales
+    if (generate_tangent_space_ && !assimp_tangent_space_)
+    {
+      const auto start = core::Clock::now();
+      for (size_t i = 0; i < meshes.size(); i++)
+      {
+        if (!mesh_instances[i].first->HasNormals())
+          tangent_generator_.GenerateNormals(*meshes[i]);
+        tangent_generator_.GenerateTangents(*meshes[i]);
+      }
+      tangent_space_duration = core::Clock::now() - start;
+    }
+
+    // Batch before the steps below, so that they run on the merged meshes
+    if (batch_meshes_)
     {
-      aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-      // TODO: collect all meshes
-      // meshes_.push_back(ProcessMesh(mesh, scene));
-      return ProcessMesh(mesh, scene);
+      meshes = batcher_.Batch(meshes);
+      mesh_statistics.resize(meshes.size());
     }
 
-    for (unsigned int i = 0; i < node->mNumChildren; i++)
+    thread_pool_.ParallelFor(meshes.size(), [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++)
+      {
+        // Reorder before compression, so that overdraw sorting can read float positions
+        if (optimize_meshes_)
+          mesh_statistics[i] = optimizer_.Optimize(*meshes[i]);
+
+        // Levels of detail index the final vertex order
+        if (generate_lods_)
+          simplifier_.GenerateLods(*meshes[i]);
+
+        // Meshlets regroup triangles after the vertex cache order, seeded in that order
+        if (build_meshlets_)
+          meshlet_builder_.Build(*meshes[i]);
+
+        if (compress_vertices_)
+          VertexCompressor().Compress(*meshes[i]);
+      }
+      });
+
+    MeshOptimizer::Statistics optimization_statistics;
+    for (const auto& statistics : mesh_statistics)
+      optimization_statistics += statistics;
+
     {
-      const auto mesh = ProcessNode(node->mChildren[i], scene);
-      if (mesh != nullptr)
-        return mesh;
+      std::lock_guard<std::mutex> lock(statistics_mutex_);
+      optimization_statistics_ = optimization_statistics;
+      tangent_space_duration_ = tangent_space_duration;
     }
 
-    return nullptr;
+    auto model = std::make_shared<Model>();
+    model->SetMeshes(std::move(meshes));
+    model->SetTextures(textures_);
+
+    // A cache that cannot be written only costs the next warm start
+    if (cache_ != nullptr)
+      cache_->Save(filepath, import_flags, *model);
+
+    return model;
+  }
+
+  std::future<std::shared_ptr<Model>> LoadAsync(const std::string& filepath)
+  {
+    return load_thread_pool_->Enqueue([this, filepath] { return Load(filepath); });
   }
 
-  std::shared_ptr<Mesh> ProcessMesh(aiMesh* mesh, const aiScene* scene)
+  void SetInterleaved(bool interleaved)
+  {
+    interleaved_ = interleaved;
+  }
+
+  void SetCompressVertices(bool compress_vertices)
+  {
+    compress_vertices_ = compress_vertices;
+  }
+
+  void SetWeldVertices(bool weld_vertices)
+  {
+    weld_vertices_ = weld_vertices;
+  }
+
+  void SetOptimizeMeshes(bool optimize_meshes)
+  {
+    optimize_meshes_ = optimize_meshes;
+  }
+
+  void SetOptimizeOverdraw(bool optimize_overdraw)
+  {
+    optimize_overdraw_ = optimize_overdraw;
+    optimizer_.SetOptimizeOverdraw(optimize_overdraw);
+  }
+
+  void SetGenerateLods(bool generate_lods)
+  {
+    generate_lods_ = generate_lods;
+  }
+
+  void SetBuildMeshlets(bool build_meshlets)
+  {
+    build_meshlets_ = build_meshlets;
+  }
+
+  void SetBatchMeshes(bool batch_meshes)
+  {
+    batch_meshes_ = batch_meshes;
+  }
+
+  MeshOptimizer::Statistics OptimizationStatistics() const
+  {
+    std::lock_guard<std::mutex> lock(statistics_mutex_);
+    return optimization_statistics_;
+  }
+
+  void SetGenerateTangentSpace(bool generate_tangent_space)
+  {
+    generate_tangent_space_ = generate_tangent_space;
+  }
+
+  void SetAssimpTangentSpace(bool assimp_tangent_space)
+  {
+    assimp_tangent_space_ = assimp_tangent_space;
+  }
+
+  std::shared_ptr<TextureTable> Textures() const
+  {
+    return textures_;
+  }
+
+  core::Duration TangentSpaceDuration() const
+  {
+    std::lock_guard<std::mutex> lock(statistics_mutex_);
+    return tangent_space_duration_;
+  }
+
+  void SetCacheDirpath(const std::string& dirpath)
+  {
+    if (dirpath.empty())
+      cache_ = nullptr;
+    else
+      cache_ = std::make_unique<MeshCache>(dirpath);
+  }
+
+  std::shared_ptr<MeshCache::View> MapCache(const std::string& filepath) const
+  {
+    if (cache_ == nullptr)
+      return nullptr;
+    return cache_->Map(filepath, ImportFlags());
+  }
+
+private:
+  unsigned int AssimpFlags() const
+  {
+    return aiProcess_Triangulate;
+  }
+
+  // Assimp post process flags in the lower 32 bits, loader options in the upper 32 bits
+  uint64_t ImportFlags() const
+  {
+    uint64_t loader_flags = 0;
+    if (interleaved_)
+      loader_flags |= 1ull << 0;
+    if (compress_vertices_)
+      loader_flags |= 1ull << 1;
+    if (optimize_meshes_)
+      loader_flags |= 1ull << 2;
+    if (optimize_meshes_ && optimize_overdraw_)
+      loader_flags |= 1ull << 3;
+    if (weld_vertices_)
+      loader_flags |= 1ull << 4;
+    if (generate_lods_)
+      loader_flags |= 1ull << 5;
+    if (build_meshlets_)
+      loader_flags |= 1ull << 6;
+    if (generate_tangent_space_)
+      loader_flags |= 1ull << 7;
+    if (generate_tangent_space_ && assimp_tangent_space_)
+      loader_flags |= 1ull << 8;
+    if (batch_meshes_)
+      loader_flags |= 1ull << 9;
+
+    return static_cast<uint64_t>(AssimpFlags()) | (loader_flags << 32);
+  }
+
+  void ProcessNode(const aiNode* node, const aiMatrix4x4& parent_transform, const aiScene* scene, std::vector<std::pair<const aiMesh*, aiMatrix4x4>>& mesh_instances)
+  {
+    const auto transform = parent_transform * node->mTransformation;
+
+    for (unsigned int i = 0; i < node->mNumMeshes; i++)
+      mesh_instances.emplace_back(scene->mMeshes[node->mMeshes[i]], transform);
+
+    for (unsigned int i = 0; i < node->mNumChildren; i++)
+      ProcessNode(node->mChildren[i], transform, scene, mesh_instances);
+  }
+
+  std::shared_ptr<Mesh> ProcessMesh(const aiMesh* mesh, const aiMatrix4x4& transform, const aiScene* scene, const std::string& dirpath) const
   {
     std::vector<float> vertices;
     std::vector<float> normals;
     std::vector<float> tex_coords;
+    std::vector<float> tangents;
+    std::vector<float> interleaved_vertices;
     std::vector<uint32_t> indices;
-    std::string texture_filepath;
 
     const auto has_texture = mesh->HasTextureCoords(0);
     const auto has_normal = mesh->HasNormals();
-
-    for (int i = 0; i < mesh->mNumVertices; i++)
+    const auto num_vertices = static_cast<size_t>(mesh->mNumVertices);
+
+    // Size every destination up front and write through strided pointers,
+    // so that planar and interleaved outputs share the same conversion loop.
+    float* position_ptr = nullptr;
+    float* normal_ptr = nullptr;
+    float* tex_coord_ptr = nullptr;
+    size_t position_stride = 3;
+    size_t normal_stride = 3;
+    size_t tex_coord_stride = 2;
+
+    if (interleaved_)
+    {
+      interleaved_vertices.resize(num_vertices * Mesh::interleaved_stride, 0.f);
+      position_ptr = interleaved_vertices.data();
+      normal_ptr = interleaved_vertices.data() + 3;
+      tex_coord_ptr = interleaved_vertices.data() + 6;
+      position_stride = normal_stride = tex_coord_stride = Mesh::interleaved_stride;
+    }
+    else
     {
-      vertices.push_back(mesh->mVertices[i].x);
-      vertices.push_back(mesh->mVertices[i].y);
-      vertices.push_back(mesh->mVertices[i].z);
+      vertices.resize(num_vertices * 3);
+      position_ptr = vertices.data();
 
       if (has_normal)
       {
-        normals.push_back(mesh->mNormals[i].x);
-        normals.push_back(mesh->mNormals[i].y);
-        normals.push_back(mesh->mNormals[i].z);
+        normals.resize(num_vertices * 3);
+        normal_ptr = normals.data();
       }
 
       if (has_texture)
       {
-        tex_coords.push_back(mesh->mTextureCoords[0][i].x);
-        tex_coords.push_back(mesh->mTextureCoords[0][i].y);
+        tex_coords.resize(num_vertices * 2);
+        tex_coord_ptr = tex_coords.data();
       }
     }
 
-    for (int i = 0; i < mesh->mNumFaces; i++)
-    {
-      aiFace face = mesh->mFaces[i];
-      for (int j = 0; j < face.mNumIndices; j++)
-        indices.push_back(face.mIndices[j]);
-    }
+    // Normals are transformed by inverse transpose of the node transform
+    const auto is_identity = transform.IsIdentity();
+    auto normal_transform = aiMatrix3x3(transform);
+    normal_transform.Inverse().Transpose();
 
-    // process material
-    if (mesh->mMaterialIndex >= 0)
+    for (size_t i = 0; i < num_vertices; i++)
     {
-      aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+      const auto vertex = is_identity ? mesh->mVertices[i] : transform * mesh->mVertices[i];
+      float* position = position_ptr + i * position_stride;
+      position[0] = vertex.x;
+      position[1] = vertex.y;
+      position[2] = vertex.z;
 
-      const auto diffuse_texture_filepaths = LoadMaterialTextureFilepaths(material, aiTextureType_DIFFUSE, "texture_diffuse");
-      if (!diffuse_texture_filepaths.empty())
-        texture_filepath = diffuse_texture_filepaths[0];
+      if (has_normal)
+      {
+        const auto normal = is_identity ? mesh->mNormals[i] : (normal_transform * mesh->mNormals[i]).Normalize();
+        float* normal_dst = normal_ptr + i * normal_stride;
+        normal_dst[0] = normal.x;
+        normal_dst[1] = normal.y;
+        normal_dst[2] = normal.z;
+      }
 
-      // TODO: load multiple textures
-      /*
-      std::vector<std::string> texture_filepaths;
+      if (has_texture)
+      {
+        float* tex_coord = tex_coord_ptr + i * tex_coord_stride;
+        tex_coord[0] = mesh->mTextureCoords[0][i].x;
+        tex_coord[1] = mesh->mTextureCoords[0][i].y;
+      }
+    }
+
+    // Tangents from aiProcess_CalcTangentSpace, with the bitangent folded into a handedness sign
+    if (mesh->HasTangentsAndBitangents() && has_normal)
+    {
+      const auto tangent_transform = aiMatrix3x3(transform);
+      tangents.resize(num_vertices * 4);
+      for (size_t i = 0; i < num_vertices; i++)
+      {
+        const auto normal = is_identity ? mesh->mNormals[i] : (normal_transform * mesh->mNormals[i]).Normalize();
+        const auto tangent = is_identity ? mesh->mTangents[i] : (tangent_transform * mesh->mTangents[i]).Normalize();
+        const auto bitangent = is_identity ? mesh->mBitangents[i] : tangent_transform * mesh->mBitangents[i];
+
+        float* tangent_dst = tangents.data() + i * 4;
+        tangent_dst[0] = tangent.x;
+        tangent_dst[1] = tangent.y;
+        tangent_dst[2] = tangent.z;
+        tangent_dst[3] = ((normal ^ tangent) * bitangent) < 0.f ? -1.f : 1.f;
+      }
+    }
 
-      const auto diffuse_texture_filepaths = LoadMaterialTextureFilepaths(material, aiTextureType_DIFFUSE, "texture_diffuse");
-      texture_filepaths.insert(texture_filepaths.end(), diffuse_texture_filepaths.begin(), diffuse_texture_filepaths.end());
+    size_t num_indices = 0;
+    for (unsigned int i = 0; i < mesh->mNumFaces; i++)
+      num_indices += mesh->mFaces[i].mNumIndices;
 
-      const auto specular_texture_filepaths = LoadMaterialTextureFilepaths(material, aiTextureType_SPECULAR, "texture_specular");
-      texture_filepaths.insert(texture_filepaths.end(), specular_texture_filepaths.begin(), specular_texture_filepaths.end());
-      */
+    indices.resize(num_indices);
+    auto* index_ptr = indices.data();
+    for (unsigned int i = 0; i < mesh->mNumFaces; i++)
+    {
+      const auto& face = mesh->mFaces[i];
+      index_ptr = std::copy(face.mIndices, face.mIndices + face.mNumIndices, index_ptr);
     }
 
     auto geometryMesh = std::make_shared<Mesh>();
     geometryMesh->SetVertices(std::move(vertices));
     geometryMesh->SetNormals(std::move(normals));
     geometryMesh->SetTexCoords(std::move(tex_coords));
+    geometryMesh->SetTangents(std::move(tangents));
+    geometryMesh->SetInterleavedVertices(std::move(interleaved_vertices));
     geometryMesh->SetIndices(std::move(indices));
-    geometryMesh->SetTextureFilepath(std::move(texture_filepath));
 
+    // Material textures by slot; OBJ bump maps are imported as height maps
+    if (mesh->mMaterialIndex < scene->mNumMaterials)
+    {
+      const aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+      geometryMesh->SetTextureId(TextureSlot::DIFFUSE, InternMaterialTexture(material, aiTextureType_DIFFUSE, dirpath));
+      geometryMesh->SetTextureId(TextureSlot::SPECULAR, InternMaterialTexture(material, aiTextureType_SPECULAR, dirpath));
+
+      auto normal_texture_id = InternMaterialTexture(material, aiTextureType_NORMALS, dirpath);
+      if (normal_texture_id == TextureTable::invalid_id)
+        normal_texture_id = InternMaterialTexture(material, aiTextureType_HEIGHT, dirpath);
+      geometryMesh->SetTextureId(TextureSlot::NORMAL, normal_texture_id);
+    }
+
+    geometryMesh->SetBounds(geometryMesh->ComputeBounds());
     return geometryMesh;
   }
 
-  std::vector<std::string> LoadMaterialTextureFilepaths(aiMaterial* mat, aiTextureType type, const std::string& typeName)
+  // First texture of the type, interned in the loader-wide table
+  uint32_t InternMaterialTexture(const aiMaterial* material, aiTextureType type, const std::string& dirpath) const
   {
-    std::vector<std::string> texture_filepaths;
+    if (material->GetTextureCount(type) == 0)
+      return TextureTable::invalid_id;
 
-    for (int i = 0; i < mat->GetTextureCount(type); i++)
-    {
-      aiString str;
-      mat->GetTexture(type, i, &str);
-      texture_filepaths.push_back(dirpath_ + '/' + str.C_Str());
-    }
-
-    return texture_filepaths;
+    aiString str;
+    material->GetTexture(type, 0, &str);
+    return textures_->Intern(dirpath + '/' + str.C_Str());
   }
 
-  std::string dirpath_;
+  bool interleaved_ = false;
+  bool compress_vertices_ = false;
+  bool weld_vertices_ = false;
+  bool optimize_meshes_ = false;
+  bool optimize_overdraw_ = false;
+  bool generate_lods_ = false;
+  bool build_meshlets_ = false;
+  bool batch_meshes_ = false;
+  bool generate_tangent_space_ = false;
+  bool assimp_tangent_space_ = false;
+
+  // Shared with the welder, optimizer and tangent generator, whose passes nest inside per-mesh tasks
+  std::unique_ptr<core::ThreadPool> own_thread_pool_;
+  core::ThreadPool& thread_pool_;
+
+  MeshWelder welder_;
+
+  MeshOptimizer optimizer_;
+  MeshOptimizer::Statistics optimization_statistics_;
+  core::Duration tangent_space_duration_{ 0. };
+  mutable std::mutex statistics_mutex_;
+  MeshSimplifier simplifier_;
+  MeshletBuilder meshlet_builder_;
+  MeshBatcher batcher_;
+  TangentGenerator tangent_generator_;
+
+  std::unique_ptr<MeshCache> cache_;
+
+  std::shared_ptr<TextureTable> textures_;
+
+  // Whole-file imports for LoadAsync, created on first use. Owned even with a shared thread_pool_, and declared
+  // last, so that pending loads finish before the rest of the loader is destroyed.
+  core::LazyThreadPool load_thread_pool_{ 2 };
 };
 
 MeshLoader::MeshLoader()
@@ -147,11 +485,96 @@ MeshLoader::MeshLoader()
   impl_ = std::make_unique<Impl>();
 }
 
+MeshLoader::MeshLoader(core::ThreadPool& thread_pool)
+{
+  impl_ = std::make_unique<Impl>(thread_pool);
+}
+
 MeshLoader::~MeshLoader() = default;
 
-std::shared_ptr<Mesh> MeshLoader::Load(const std::string& filepath)
+std::shared_ptr<Model> MeshLoader::Load(const std::string& filepath)
 {
   return impl_->Load(filepath);
 }
+
+std::future<std::shared_ptr<Model>> MeshLoader::LoadAsync(const std::string& filepath)
+{
+  return impl_->LoadAsync(filepath);
+}
+
+void MeshLoader::SetInterleaved(bool interleaved)
+{
+  impl_->SetInterleaved(interleaved);
+}
+
+void MeshLoader::SetCompressVertices(bool compress_vertices)
+{
+  impl_->SetCompressVertices(compress_vertices);
+}
+
+void MeshLoader::SetWeldVertices(bool weld_vertices)
+{
+  impl_->SetWeldVertices(weld_vertices);
+}
+
+void MeshLoader::SetOptimizeMeshes(bool optimize_meshes)
+{
+  impl_->SetOptimizeMeshes(optimize_meshes);
+}
+
+void MeshLoader::SetOptimizeOverdraw(bool optimize_overdraw)
+{
+  impl_->SetOptimizeOverdraw(optimize_overdraw);
+}
+
+void MeshLoader::SetGenerateLods(bool generate_lods)
+{
+  impl_->SetGenerateLods(generate_lods);
+}
+
+void MeshLoader::SetBuildMeshlets(bool build_meshlets)
+{
+  impl_->SetBuildMeshlets(build_meshlets);
+}
+
+void MeshLoader::SetBatchMeshes(bool batch_meshes)
+{
+  impl_->SetBatchMeshes(batch_meshes);
+}
+
+MeshOptimizer::Statistics MeshLoader::OptimizationStatistics() const
+{
+  return impl_->OptimizationStatistics();
+}
+
+void MeshLoader::SetGenerateTangentSpace(bool generate_tangent_space)
+{
+  impl_->SetGenerateTangentSpace(generate_tangent_space);
+}
+
+void MeshLoader::SetAssimpTangentSpace(bool assimp_tangent_space)
+{
+  impl_->SetAssimpTangentSpace(assimp_tangent_space);
+}
+
+core::Duration MeshLoader::TangentSpaceDuration() const
+{
+  return impl_->TangentSpaceDuration();
+}
+
+std::shared_ptr<TextureTable> MeshLoader::Textures() const
+{
+  return impl_->Textures();
+}
+
+void MeshLoader::SetCacheDirpath(const std::string& dirpath)
+{
+  impl_->SetCacheDirpath(dirpath);
+}
+
+std::shared_ptr<MeshCache::View> MeshLoader::MapCache(const std::string& filepath) const
+{
+  return impl_->MapCache(filepath);
+}
 }
 }
@@ -1,22 +1,87 @@
 #ifndef TWOPI_GEOMETRY_MESH_LAODER_H_
 #define TWOPI_GEOMETRY_MESH_LAODER_H_
 
+#include <future>
 #include <memory>
 #include <string>
 
+#include <twopi/core/timestamp.h>
+#include <twopi/geometry/mesh_cache.h>
+#include <twopi/geometry/mesh_optimizer.h>
+
 namespace twopi
 {
+namespace core
+{
+class ThreadPool;
+}
+
 namespace geometry
 {
-class Mesh;
+class Model;
+class TextureTable;
 
 class MeshLoader
 {
 public:
   MeshLoader();
+
+  // Converts meshes on thread_pool, e.g. one shared with image decoding, instead of a pool of its own
+  explicit MeshLoader(core::ThreadPool& thread_pool);
+
   ~MeshLoader();
 
-  std::shared_ptr<Mesh> Load(const std::string& filepath);
+  std::shared_ptr<Model> Load(const std::string& filepath);
+
+  // Imports and converts on background threads; the future rethrows load errors.
+  // Options must not change while loads are pending, and the destructor waits for them.
+  std::future<std::shared_ptr<Model>> LoadAsync(const std::string& filepath);
+
+  // Emit a single position/normal/tex_coord array per mesh instead of separate attribute arrays
+  void SetInterleaved(bool interleaved);
+
+  // Emit Mesh::CompressedVertices (quantized positions, octahedral normals, half tex coords) instead of floats
+  void SetCompressVertices(bool compress_vertices);
+
+  // Merge duplicate vertices of each mesh, e.g. per-face corners of OBJ files
+  void SetWeldVertices(bool weld_vertices);
+
+  // Reorder triangles and vertices of each mesh for the vertex cache and vertex fetch
+  void SetOptimizeMeshes(bool optimize_meshes);
+
+  // Also sort triangle clusters to reduce overdraw when optimizing meshes
+  void SetOptimizeOverdraw(bool optimize_overdraw);
+
+  // Generate Mesh::Lods with quadric edge collapse
+  void SetGenerateLods(bool generate_lods);
+
+  // Partition each mesh into Mesh::Meshlets for cluster culling; reorders the full resolution triangles
+  void SetBuildMeshlets(bool build_meshlets);
+
+  // Merge meshes sharing textures into batches with MeshBatcher, drawn with one call each
+  void SetBatchMeshes(bool batch_meshes);
+
+  // ACMR/ATVR before and after optimization over the last imported model; empty on cache hits
+  MeshOptimizer::Statistics OptimizationStatistics() const;
+
+  // Generate smooth normals where missing, and Mesh::Tangents with TangentGenerator
+  void SetGenerateTangentSpace(bool generate_tangent_space);
+
+  // Generate the tangent space with aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace instead, for comparison
+  void SetAssimpTangentSpace(bool assimp_tangent_space);
+
+  // Wall time of tangent space generation in the last import, by either generator; zero on cache hits
+  core::Duration TangentSpaceDuration() const;
+
+  // Texture filepaths of every model loaded by this loader, referenced by Mesh::TextureId
+  std::shared_ptr<TextureTable> Textures() const;
+
+  // Directory of binary .tpmesh caches; warm starts skip assimp. Empty string disables caching.
+  void SetCacheDirpath(const std::string& dirpath);
+
+  // Mapped cache of filepath under the current options, for uploads straight from the file; nullptr without a
+  // valid cache, in which case Load imports the model and writes one
+  std::shared_ptr<MeshCache::View> MapCache(const std::string& filepath) const;
 
 private:
   class Impl;
@@ -0,0 +1,470 @@
+#include <twopi/geometry/mesh_optimizer.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+
+#include <twopi/core/thread_pool.h>
+#include <twopi/geometry/mesh.h>
+#include <twopi/geometry/model.h>
+
+namespace twopi
+{
+namespace geometry
+{
+namespace
+{
+// Soft cluster boundaries may raise ACMR by at most this factor
+constexpr float soft_boundary_threshold = 1.05f;
+
+// Triangles adjacent to each vertex, in compressed row storage
+struct Adjacency
+{
+  std::vector<uint32_t> offsets;
+  std::vector<uint32_t> triangles;
+
+  Adjacency(const std::vector<uint32_t>& indices, int num_vertices)
+    : offsets(static_cast<size_t>(num_vertices) + 1, 0)
+    , triangles(indices.size())
+  {
+    for (auto index : indices)
+      offsets[index + 1]++;
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < indices.size(); i++)
+      triangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+  }
+
+  uint32_t Count(uint32_t vertex) const { return offsets[vertex + 1] - offsets[vertex]; }
+  const uint32_t* begin(uint32_t vertex) const { return triangles.data() + offsets[vertex]; }
+  const uint32_t* end(uint32_t vertex) const { return triangles.data() + offsets[vertex + 1]; }
+};
+
+// Tipsify [Sander et al. 2007]. Returns triangle order, and cluster starts at hard boundaries
+// where the walk restarts from a non-adjacent vertex.
+std::vector<uint32_t> Tipsify(const std::vector<uint32_t>& indices, int num_vertices, int cache_size, std::vector<uint32_t>& cluster_starts)
+{
+  const auto num_triangles = static_cast<uint32_t>(indices.size() / 3);
+  const Adjacency adjacency(indices, num_vertices);
+
+  std::vector<uint32_t> live_triangles(num_vertices);
+  for (int i = 0; i < num_vertices; i++)
+    live_triangles[i] = adjacency.Count(i);
+
+  std::vector<uint32_t> cache_time(num_vertices, 0);
+  std::vector<bool> emitted(num_triangles, false);
+  std::vector<uint32_t> dead_end;
+  std::vector<uint32_t> candidates;
+
+  std::vector<uint32_t> order;
+  order.reserve(num_triangles);
+
+  uint32_t time = cache_size + 1;
+  uint32_t cursor = 0;
+  int64_t vertex = 0;
+  cluster_starts.push_back(0);
+
+  while (vertex >= 0)
+  {
+    candidates.clear();
+
+    for (auto it = adjacency.begin(vertex); it != adjacency.end(vertex); it++)
+    {
+      const auto triangle = *it;
+      if (emitted[triangle])
+        continue;
+
+      for (int j = 0; j < 3; j++)
+      {
+        const auto v = indices[triangle * 3 + j];
+        dead_end.push_back(v);
+        candidates.push_back(v);
+        live_triangles[v]--;
+
+        if (time - cache_time[v] > static_cast<uint32_t>(cache_size))
+          cache_time[v] = time++;
+      }
+
+      emitted[triangle] = true;
+      order.push_back(triangle);
+    }
+
+    // Prefer a 1-ring candidate that stays in cache while its remaining triangles are emitted
+    int64_t best = -1;
+    int64_t best_priority = -1;
+    for (auto v : candidates)
+    {
+      if (live_triangles[v] == 0)
+        continue;
+
+      int64_t priority = 0;
+      if (time - cache_time[v] + 2 * live_triangles[v] <= static_cast<uint32_t>(cache_size))
+        priority = time - cache_time[v];
+
+      if (priority > best_priority)
+      {
+        best_priority = priority;
+        best = v;
+      }
+    }
+
+    if (best < 0)
+    {
+      // Hard boundary: restart from recently referenced vertices, then from the lowest unfinished vertex
+      while (!dead_end.empty() && best < 0)
+      {
+        const auto v = dead_end.back();
+        dead_end.pop_back();
+        if (live_triangles[v] > 0)
+          best = v;
+      }
+
+      while (best < 0 && cursor < static_cast<uint32_t>(num_vertices))
+      {
+        if (live_triangles[cursor] > 0)
+          best = cursor;
+        cursor++;
+      }
+
+      if (best >= 0 && order.size() > cluster_starts.back())
+        cluster_starts.push_back(static_cast<uint32_t>(order.size()));
+    }
+
+    vertex = best;
+  }
+
+  return order;
+}
+
+// Soft boundaries [Sander et al. 2007]: splits clusters wherever the ACMR of the current cluster, simulated from an
+// empty cache, has dropped to threshold times the ACMR of the whole order. Any piece may follow any other once
+// sorted, so the split costs at most that factor in cache efficiency, and gives the sort finer clusters.
+std::vector<uint32_t> SplitClusters(const std::vector<uint32_t>& indices, int num_vertices, int cache_size, const std::vector<uint32_t>& order, const std::vector<uint32_t>& cluster_starts, float threshold)
+{
+  const auto num_triangles = static_cast<uint32_t>(order.size());
+
+  std::vector<uint32_t> ordered_indices(static_cast<size_t>(num_triangles) * 3);
+  for (uint32_t i = 0; i < num_triangles; i++)
+    std::copy_n(indices.data() + static_cast<size_t>(order[i]) * 3, 3, ordered_indices.data() + static_cast<size_t>(i) * 3);
+
+  const auto acmr = static_cast<double>(MeshOptimizer::SimulateFifoCache(ordered_indices, num_vertices, cache_size)) / num_triangles;
+
+  // Same FIFO model as SimulateFifoCache; advancing the miss count by cache_size flushes the cache
+  std::vector<uint64_t> push_time(num_vertices, 0);
+  uint64_t misses = 0;
+
+  std::vector<uint32_t> split_starts;
+  size_t next_hard_start = 0;
+  uint32_t cluster_start = 0;
+  uint64_t cluster_misses = 0;
+  for (uint32_t i = 0; i < num_triangles; i++)
+  {
+    const auto hard = next_hard_start < cluster_starts.size() && cluster_starts[next_hard_start] == i;
+    if (hard)
+      next_hard_start++;
+
+    if (hard || (i > cluster_start && misses - cluster_misses <= threshold * acmr * (i - cluster_start)))
+    {
+      split_starts.push_back(i);
+      misses += cache_size;
+      cluster_start = i;
+      cluster_misses = misses;
+    }
+
+    for (int j = 0; j < 3; j++)
+    {
+      const auto v = ordered_indices[static_cast<size_t>(i) * 3 + j];
+      if (push_time[v] == 0 || misses - push_time[v] >= static_cast<uint64_t>(cache_size))
+      {
+        misses++;
+        push_time[v] = misses;
+      }
+    }
+  }
+
+  return split_starts;
+}
+
+// Sorts clusters so that triangles facing away from the mesh center are drawn first [Sander et al. 2007]
+void SortClustersForOverdraw(const Mesh& mesh, const std::vector<uint32_t>& indices, std::vector<uint32_t>& order, const std::vector<uint32_t>& cluster_starts)
+{
+  const auto positions = mesh.PositionView();
+  if (!positions)
+    return;
+
+  const auto num_clusters = cluster_starts.size();
+  if (num_clusters <= 1)
+    return;
+
+  std::array<double, 3> mesh_center{ 0., 0., 0. };
+  std::vector<std::array<float, 3>> centers(num_clusters);
+  std::vector<std::array<float, 3>> normals(num_clusters);
+  double total_area = 0.;
+
+  for (size_t c = 0; c < num_clusters; c++)
+  {
+    const auto begin = cluster_starts[c];
+    const auto end = c + 1 < num_clusters ? cluster_starts[c + 1] : static_cast<uint32_t>(order.size());
+
+    std::array<float, 3> center{ 0.f, 0.f, 0.f };
+    std::array<float, 3> normal{ 0.f, 0.f, 0.f };
+    float area_sum = 0.f;
+
+    for (auto i = begin; i < end; i++)
+    {
+      const auto* p0 = positions[indices[order[i] * 3 + 0]];
+      const auto* p1 = positions[indices[order[i] * 3 + 1]];
+      const auto* p2 = positions[indices[order[i] * 3 + 2]];
+
+      const float e0[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+      const float e1[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+      const float n[3] = {
+        e0[1] * e1[2] - e0[2] * e1[1],
+        e0[2] * e1[0] - e0[0] * e1[2],
+        e0[0] * e1[1] - e0[1] * e1[0],
+      };
+
+      // Area weighted; |n| is twice the triangle area
+      const auto area = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+      for (int j = 0; j < 3; j++)
+      {
+        center[j] += (p0[j] + p1[j] + p2[j]) / 3.f * area;
+        normal[j] += n[j];
+      }
+      area_sum += area;
+    }
+
+    for (int j = 0; j < 3; j++)
+    {
+      mesh_center[j] += center[j];
+      center[j] = area_sum > 0.f ? center[j] / area_sum : positions[indices[order[begin] * 3]][j];
+    }
+    total_area += area_sum;
+
+    centers[c] = center;
+    normals[c] = normal;
+  }
+
+  for (auto& v : mesh_center)
+    v = total_area > 0. ? v / total_area : 0.;
+
+  std::vector<float> sort_keys(num_clusters);
+  for (size_t c = 0; c < num_clusters; c++)
+  {
+    sort_keys[c] = 0.f;
+    for (int j = 0; j < 3; j++)
+      sort_keys[c] += (centers[c][j] - static_cast<float>(mesh_center[j])) * normals[c][j];
+  }
+
+  std::vector<uint32_t> cluster_order(num_clusters);
+  std::iota(cluster_order.begin(), cluster_order.end(), 0);
+  std::stable_sort(cluster_order.begin(), cluster_order.end(), [&sort_keys](uint32_t lhs, uint32_t rhs) {
+    return sort_keys[lhs] > sort_keys[rhs];
+    });
+
+  std::vector<uint32_t> sorted_order;
+  sorted_order.reserve(order.size());
+  for (auto c : cluster_order)
+  {
+    const auto begin = cluster_starts[c];
+    const auto end = c + 1 < num_clusters ? cluster_starts[c + 1] : static_cast<uint32_t>(order.size());
+    sorted_order.insert(sorted_order.end(), order.begin() + begin, order.begin() + end);
+  }
+  order = std::move(sorted_order);
+}
+
+template <typename T>
+std::vector<T> RemapVertices(const std::vector<T>& vertices, int stride, const std::vector<uint32_t>& new_to_old)
+{
+  if (vertices.empty())
+    return {};
+
+  std::vector<T> remapped(vertices.size());
+  for (size_t i = 0; i < new_to_old.size(); i++)
+    std::copy_n(vertices.data() + static_cast<size_t>(new_to_old[i]) * stride, stride, remapped.data() + i * stride);
+  return remapped;
+}
+}
+
+class MeshOptimizer::Impl
+{
+public:
+  Impl()
+  {
+  }
+
+  explicit Impl(core::ThreadPool& thread_pool)
+    : thread_pool_(thread_pool)
+  {
+  }
+
+  ~Impl() = default;
+
+  void SetCacheSize(int cache_size)
+  {
+    cache_size_ = std::max(cache_size, 3);
+  }
+
+  void SetOptimizeOverdraw(bool optimize_overdraw)
+  {
+    optimize_overdraw_ = optimize_overdraw;
+  }
+
+  Statistics Optimize(Mesh& mesh) const
+  {
+    Statistics statistics;
+    statistics.num_meshes = 1;
+
+    const auto num_vertices = mesh.NumVertices();
+    const auto& indices = mesh.Indices();
+    const auto num_triangles = static_cast<uint32_t>(indices.size() / 3);
+
+    statistics.num_vertices = num_vertices;
+    statistics.num_triangles = num_triangles;
+    statistics.transforms_before = SimulateFifoCache(indices, num_vertices, cache_size_);
+
+    if (num_triangles == 0)
+    {
+      statistics.transforms_after = statistics.transforms_before;
+      return statistics;
+    }
+
+    // Triangle order for vertex cache, then overdraw
+    std::vector<uint32_t> cluster_starts;
+    auto order = Tipsify(indices, num_vertices, cache_size_, cluster_starts);
+    if (optimize_overdraw_)
+    {
+      cluster_starts = SplitClusters(indices, num_vertices, cache_size_, order, cluster_starts, soft_boundary_threshold);
+      SortClustersForOverdraw(mesh, indices, order, cluster_starts);
+    }
+
+    // Vertex fetch order: vertices in order of first use, unreferenced vertices last
+    constexpr auto unused = ~0u;
+    std::vector<uint32_t> old_to_new(num_vertices, unused);
+    std::vector<uint32_t> new_to_old;
+    new_to_old.reserve(num_vertices);
+
+    std::vector<uint32_t> optimized_indices(static_cast<size_t>(num_triangles) * 3);
+    for (uint32_t i = 0; i < num_triangles; i++)
+    {
+      for (int j = 0; j < 3; j++)
+      {
+        const auto old_index = indices[order[i] * 3 + j];
+        if (old_to_new[old_index] == unused)
+        {
+          old_to_new[old_index] = static_cast<uint32_t>(new_to_old.size());
+          new_to_old.push_back(old_index);
+        }
+        optimized_indices[i * 3 + j] = old_to_new[old_index];
+      }
+    }
+
+    for (int i = 0; i < num_vertices; i++)
+    {
+      if (old_to_new[i] == unused)
+      {
+        old_to_new[i] = static_cast<uint32_t>(new_to_old.size());
+        new_to_old.push_back(i);
+      }
+    }
+
+    mesh.SetVertices(RemapVertices(mesh.Vertices(), 3, new_to_old));
+    mesh.SetNormals(RemapVertices(mesh.Normals(), 3, new_to_old));
+    mesh.SetTexCoords(RemapVertices(mesh.TexCoords(), 2, new_to_old));
+    mesh.SetTangents(RemapVertices(mesh.Tangents(), 4, new_to_old));
+    mesh.SetInterleavedVertices(RemapVertices(mesh.InterleavedVertices(), Mesh::interleaved_stride, new_to_old));
+    mesh.SetCompressedVertices(RemapVertices(mesh.CompressedVertices(), Mesh::compressed_stride, new_to_old));
+
+    // Levels of detail share the vertices
+    auto lods = mesh.Lods();
+    for (auto& lod : lods)
+    {
+      for (auto& index : lod.indices)
+        index = old_to_new[index];
+    }
+    mesh.SetLods(std::move(lods));
+
+    statistics.transforms_after = SimulateFifoCache(optimized_indices, num_vertices, cache_size_);
+    mesh.SetIndices(std::move(optimized_indices));
+
+    // Triangle order changed, so meshlet ranges no longer apply
+    mesh.SetMeshlets({});
+
+    return statistics;
+  }
+
+  Statistics Optimize(Model& model)
+  {
+    const auto& meshes = model.Meshes();
+    std::vector<Statistics> mesh_statistics(meshes.size());
+    thread_pool_->ParallelFor(meshes.size(), [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++)
+        mesh_statistics[i] = Optimize(*meshes[i]);
+      });
+
+    Statistics statistics;
+    for (const auto& mesh_statistic : mesh_statistics)
+      statistics += mesh_statistic;
+    return statistics;
+  }
+
+private:
+  int cache_size_ = 16;
+  bool optimize_overdraw_ = false;
+
+  core::LazyThreadPool thread_pool_;
+};
+
+MeshOptimizer::MeshOptimizer()
+{
+  impl_ = std::make_unique<Impl>();
+}
+
+MeshOptimizer::MeshOptimizer(core::ThreadPool& thread_pool)
+{
+  impl_ = std::make_unique<Impl>(thread_pool);
+}
+
+MeshOptimizer::~MeshOptimizer() = default;
+
+void MeshOptimizer::SetCacheSize(int cache_size)
+{
+  impl_->SetCacheSize(cache_size);
+}
+
+void MeshOptimizer::SetOptimizeOverdraw(bool optimize_overdraw)
+{
+  impl_->SetOptimizeOverdraw(optimize_overdraw);
+}
+
+MeshOptimizer::Statistics MeshOptimizer::Optimize(Mesh& mesh) const
+{
+  return impl_->Optimize(mesh);
+}
+
+MeshOptimizer::Statistics MeshOptimizer::Optimize(Model& model)
+{
+  return impl_->Optimize(model);
+}
+
+uint64_t MeshOptimizer::SimulateFifoCache(const std::vector<uint32_t>& indices, int num_vertices, int cache_size)
+{
+  // A vertex is in cache if it was pushed within the last cache_size misses
+  std::vector<uint64_t> push_time(num_vertices, 0);
+  uint64_t misses = 0;
+
+  for (auto index : indices)
+  {
+    if (push_time[index] == 0 || misses - push_time[index] >= static_cast<uint64_t>(cache_size))
+    {
+      misses++;
+      push_time[index] = misses;
+    }
+  }
+
+  return misses;
+}
+}
+}
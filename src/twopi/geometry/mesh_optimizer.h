@@ -0,0 +1,83 @@
+#ifndef TWOPI_GEOMETRY_MESH_OPTIMIZER_H_
+#define TWOPI_GEOMETRY_MESH_OPTIMIZER_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace twopi
+{
+namespace core
+{
+class ThreadPool;
+}
+
+namespace geometry
+{
+class Mesh;
+class Model;
+
+// Reorders triangles for the post-transform vertex cache (Tipsify), optionally sorts triangle clusters
+// to reduce overdraw, and reorders vertices in first-use order for vertex fetch locality.
+class MeshOptimizer
+{
+public:
+  struct Statistics
+  {
+    int num_meshes = 0;
+    uint64_t num_vertices = 0;
+    uint64_t num_triangles = 0;
+
+    // Vertex shader invocations, simulated with a FIFO post-transform cache
+    uint64_t transforms_before = 0;
+    uint64_t transforms_after = 0;
+
+    // Average cache miss ratio: vertex shader invocations per triangle
+    float AcmrBefore() const { return num_triangles ? static_cast<float>(transforms_before) / num_triangles : 0.f; }
+    float AcmrAfter() const { return num_triangles ? static_cast<float>(transforms_after) / num_triangles : 0.f; }
+
+    // Average transform to vertex ratio: vertex shader invocations per vertex, 1 is optimal
+    float AtvrBefore() const { return num_vertices ? static_cast<float>(transforms_before) / num_vertices : 0.f; }
+    float AtvrAfter() const { return num_vertices ? static_cast<float>(transforms_after) / num_vertices : 0.f; }
+
+    Statistics& operator += (const Statistics& rhs)
+    {
+      num_meshes += rhs.num_meshes;
+      num_vertices += rhs.num_vertices;
+      num_triangles += rhs.num_triangles;
+      transforms_before += rhs.transforms_before;
+      transforms_after += rhs.transforms_after;
+      return *this;
+    }
+  };
+
+public:
+  MeshOptimizer();
+
+  // Optimizes the meshes of a model on thread_pool instead of a pool of its own
+  explicit MeshOptimizer(core::ThreadPool& thread_pool);
+
+  ~MeshOptimizer();
+
+  // Target post-transform cache size, 16 by default
+  void SetCacheSize(int cache_size);
+
+  // Sort triangle clusters front-to-back from the outside, at a small cost in ACMR. Disabled by default.
+  void SetOptimizeOverdraw(bool optimize_overdraw);
+
+  Statistics Optimize(Mesh& mesh) const;
+
+  // Optimizes meshes in parallel
+  Statistics Optimize(Model& model);
+
+  // Number of vertex shader invocations for indices with a FIFO cache of cache_size
+  static uint64_t SimulateFifoCache(const std::vector<uint32_t>& indices, int num_vertices, int cache_size);
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+}
+}
+
+#endif // TWOPI_GEOMETRY_MESH_OPTIMIZER_H_
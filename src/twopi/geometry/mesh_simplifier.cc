@@ -0,0 +1,469 @@
+#include <twopi/geometry/mesh_simplifier.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include <twopi/geometry/mesh.h>
+
+namespace twopi
+{
+namespace geometry
+{
+namespace
+{
+using Vector3 = std::array<double, 3>;
+
+Vector3 Subtract(const float* a, const float* b)
+{
+  return { static_cast<double>(a[0]) - b[0], static_cast<double>(a[1]) - b[1], static_cast<double>(a[2]) - b[2] };
+}
+
+Vector3 Cross(const Vector3& a, const Vector3& b)
+{
+  return { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+}
+
+double Dot(const Vector3& a, const Vector3& b)
+{
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+double Length(const Vector3& a)
+{
+  return std::sqrt(Dot(a, a));
+}
+
+// Symmetric Q(p) = p^T A p + 2 b^T p + c, weighted by the accumulated triangle area
+struct Quadric
+{
+  double a00 = 0., a11 = 0., a22 = 0., a01 = 0., a02 = 0., a12 = 0.;
+  double b0 = 0., b1 = 0., b2 = 0.;
+  double c = 0.;
+  double weight = 0.;
+
+  // Squared distance to the plane n.p + d = 0, with unit normal n
+  void AddPlane(const Vector3& n, double d, double w)
+  {
+    a00 += w * n[0] * n[0];
+    a11 += w * n[1] * n[1];
+    a22 += w * n[2] * n[2];
+    a01 += w * n[0] * n[1];
+    a02 += w * n[0] * n[2];
+    a12 += w * n[1] * n[2];
+    b0 += w * n[0] * d;
+    b1 += w * n[1] * d;
+    b2 += w * n[2] * d;
+    c += w * d * d;
+  }
+
+  Quadric& operator += (const Quadric& rhs)
+  {
+    a00 += rhs.a00; a11 += rhs.a11; a22 += rhs.a22;
+    a01 += rhs.a01; a02 += rhs.a02; a12 += rhs.a12;
+    b0 += rhs.b0; b1 += rhs.b1; b2 += rhs.b2;
+    c += rhs.c;
+    weight += rhs.weight;
+    return *this;
+  }
+
+  // Mean squared distance of p to the accumulated planes
+  double Error(const float* p) const
+  {
+    const double x = p[0];
+    const double y = p[1];
+    const double z = p[2];
+    const auto q =
+      a00 * x * x + a11 * y * y + a22 * z * z +
+      2. * (a01 * x * y + a02 * x * z + a12 * y * z) +
+      2. * (b0 * x + b1 * y + b2 * z) + c;
+    return std::max(q, 0.) / (weight > 0. ? weight : 1.);
+  }
+};
+
+enum class VertexKind : uint8_t
+{
+  INTERIOR,
+  BORDER,
+  LOCKED,
+};
+
+// Border edges weigh more than the surface, so that silhouettes of open meshes are preserved
+constexpr double border_weight = 10.;
+
+uint64_t EdgeKey(uint32_t a, uint32_t b)
+{
+  return (static_cast<uint64_t>(a) << 32) | b;
+}
+}
+
+class MeshSimplifier::Impl
+{
+public:
+  Impl()
+  {
+  }
+
+  ~Impl() = default;
+
+  void SetLodRatio(float lod_ratio)
+  {
+    lod_ratio_ = std::clamp(lod_ratio, 0.05f, 0.95f);
+  }
+
+  void SetMaxLods(int max_lods)
+  {
+    max_lods_ = std::max(max_lods, 0);
+  }
+
+  void SetMaxError(float max_error)
+  {
+    max_error_ = std::max(max_error, 0.f);
+  }
+
+  std::vector<uint32_t> Simplify(const Mesh& mesh, const std::vector<uint32_t>& indices, size_t target_index_count, float* error) const
+  {
+    const auto positions = mesh.Positions();
+    auto levels = SimplifyLevels(positions, indices, target_index_count, 1, max_error_ * Diagonal(positions));
+
+    if (error != nullptr)
+      *error = levels[0].error;
+    return std::move(levels[0].indices);
+  }
+
+  void GenerateLods(Mesh& mesh) const
+  {
+    const auto& indices = mesh.Indices();
+    std::vector<MeshLod> lods;
+
+    if (!indices.empty() && max_lods_ > 0)
+    {
+      const auto positions = mesh.Positions();
+      const auto first_target_index_count = static_cast<size_t>(indices.size() / 3 * lod_ratio_) * 3;
+      auto levels = SimplifyLevels(positions, indices, first_target_index_count, max_lods_, max_error_ * Diagonal(positions));
+
+      // Stop when the error bound no longer allows meaningful reduction
+      auto previous_index_count = indices.size();
+      for (auto& level : levels)
+      {
+        if (level.indices.empty() || level.indices.size() > previous_index_count * 9 / 10)
+          break;
+
+        previous_index_count = level.indices.size();
+        lods.emplace_back(std::move(level));
+      }
+    }
+
+    mesh.SetLods(std::move(lods));
+  }
+
+private:
+  static float Diagonal(const std::vector<float>& positions)
+  {
+    if (positions.empty())
+      return 0.f;
+
+    std::array<float, 3> box_min{ positions[0], positions[1], positions[2] };
+    std::array<float, 3> box_max = box_min;
+    for (size_t i = 0; i < positions.size(); i += 3)
+    {
+      for (int j = 0; j < 3; j++)
+      {
+        box_min[j] = std::min(box_min[j], positions[i + j]);
+        box_max[j] = std::max(box_max[j], positions[i + j]);
+      }
+    }
+
+    const float d[3] = { box_max[0] - box_min[0], box_max[1] - box_min[1], box_max[2] - box_min[2] };
+    return std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+  }
+
+  // Simplifies towards target_index_count, then continues from each result towards lod_ratio_ of it.
+  // Quadrics accumulate over collapses, so the error of every level is measured against the original surface.
+  std::vector<MeshLod> SimplifyLevels(const std::vector<float>& positions, std::vector<uint32_t> indices, size_t target_index_count, int num_levels, float max_error) const
+  {
+    const auto num_vertices = static_cast<uint32_t>(positions.size() / 3);
+    const auto* p = positions.data();
+
+    // Vertices sharing a position with different attributes form a seam; wedge is the first such vertex
+    std::vector<uint32_t> sorted_vertices(num_vertices);
+    std::iota(sorted_vertices.begin(), sorted_vertices.end(), 0);
+    std::sort(sorted_vertices.begin(), sorted_vertices.end(), [p](uint32_t lhs, uint32_t rhs) {
+      return std::lexicographical_compare(p + lhs * 3, p + lhs * 3 + 3, p + rhs * 3, p + rhs * 3 + 3) ||
+        (std::equal(p + lhs * 3, p + lhs * 3 + 3, p + rhs * 3) && lhs < rhs);
+      });
+
+    std::vector<uint32_t> wedges(num_vertices);
+    std::vector<VertexKind> kinds(num_vertices, VertexKind::INTERIOR);
+    for (uint32_t i = 0; i < num_vertices;)
+    {
+      uint32_t j = i + 1;
+      while (j < num_vertices && std::equal(p + sorted_vertices[i] * 3, p + sorted_vertices[i] * 3 + 3, p + sorted_vertices[j] * 3))
+        j++;
+
+      for (auto k = i; k < j; k++)
+      {
+        wedges[sorted_vertices[k]] = sorted_vertices[i];
+        if (j - i > 1)
+          kinds[sorted_vertices[k]] = VertexKind::LOCKED;
+      }
+      i = j;
+    }
+
+    // Border edges appear in one direction only over wedges
+    std::vector<uint64_t> edges;
+    edges.reserve(indices.size());
+    for (size_t t = 0; t + 2 < indices.size(); t += 3)
+    {
+      for (int e = 0; e < 3; e++)
+        edges.push_back(EdgeKey(wedges[indices[t + e]], wedges[indices[t + (e + 1) % 3]]));
+    }
+    std::sort(edges.begin(), edges.end());
+
+    std::vector<uint64_t> border_edges;
+    std::vector<Quadric> quadrics(num_vertices);
+    for (size_t t = 0; t + 2 < indices.size(); t += 3)
+    {
+      const uint32_t w[3] = { wedges[indices[t]], wedges[indices[t + 1]], wedges[indices[t + 2]] };
+      const auto normal = Cross(Subtract(p + w[1] * 3, p + w[0] * 3), Subtract(p + w[2] * 3, p + w[0] * 3));
+      const auto length = Length(normal);
+      if (length == 0.)
+        continue;
+
+      const Vector3 n{ normal[0] / length, normal[1] / length, normal[2] / length };
+      const auto d = -(n[0] * p[w[0] * 3] + n[1] * p[w[0] * 3 + 1] + n[2] * p[w[0] * 3 + 2]);
+      const auto area = length * 0.5;
+      for (auto v : w)
+      {
+        quadrics[v].AddPlane(n, d, area);
+        quadrics[v].weight += area;
+      }
+
+      for (int e = 0; e < 3; e++)
+      {
+        const auto a = w[e];
+        const auto b = w[(e + 1) % 3];
+        if (std::binary_search(edges.begin(), edges.end(), EdgeKey(b, a)))
+          continue;
+
+        border_edges.push_back(EdgeKey(a, b));
+        border_edges.push_back(EdgeKey(b, a));
+
+        // Plane through the border edge, perpendicular to the triangle
+        const auto edge = Subtract(p + b * 3, p + a * 3);
+        auto m = Cross(edge, n);
+        const auto m_length = Length(m);
+        if (m_length == 0.)
+          continue;
+        for (auto& v : m)
+          v /= m_length;
+
+        const auto md = -(m[0] * p[a * 3] + m[1] * p[a * 3 + 1] + m[2] * p[a * 3 + 2]);
+        const auto w_border = Dot(edge, edge) * border_weight;
+        quadrics[a].AddPlane(m, md, w_border);
+        quadrics[b].AddPlane(m, md, w_border);
+
+        if (kinds[a] == VertexKind::INTERIOR)
+          kinds[a] = VertexKind::BORDER;
+        if (kinds[b] == VertexKind::INTERIOR)
+          kinds[b] = VertexKind::BORDER;
+      }
+    }
+    std::sort(border_edges.begin(), border_edges.end());
+
+    const auto max_error_squared = static_cast<double>(max_error) * max_error;
+    double result_error_squared = 0.;
+
+    struct Collapse
+    {
+      uint32_t from;
+      uint32_t to;
+      double error;
+    };
+    std::vector<Collapse> collapses;
+    std::vector<uint32_t> collapse_remap(num_vertices);
+    std::vector<bool> touched(num_vertices);
+    std::vector<uint32_t> adjacency_offsets(num_vertices + 1);
+    std::vector<uint32_t> adjacency;
+
+    std::vector<MeshLod> levels;
+    bool stuck = false;
+    while (static_cast<int>(levels.size()) < num_levels)
+    {
+      // A level is complete when its target is reached, or when no collapse fits in the error bound
+      if (indices.size() <= target_index_count || stuck)
+      {
+        MeshLod level;
+        level.indices = indices;
+        level.error = static_cast<float>(std::sqrt(result_error_squared));
+        levels.emplace_back(std::move(level));
+
+        if (stuck)
+          break;
+
+        target_index_count = static_cast<size_t>(indices.size() / 3 * lod_ratio_) * 3;
+        continue;
+      }
+
+      // Collapse candidates over both directions of every edge
+      collapses.clear();
+      for (size_t t = 0; t < indices.size(); t += 3)
+      {
+        for (int e = 0; e < 3; e++)
+        {
+          const auto a = indices[t + e];
+          const auto b = indices[t + (e + 1) % 3];
+          for (const auto& [from, to] : { std::make_pair(a, b), std::make_pair(b, a) })
+          {
+            if (kinds[from] == VertexKind::LOCKED)
+              continue;
+            if (kinds[from] == VertexKind::BORDER && !std::binary_search(border_edges.begin(), border_edges.end(), EdgeKey(wedges[from], wedges[to])))
+              continue;
+
+            auto quadric = quadrics[wedges[from]];
+            quadric += quadrics[wedges[to]];
+            collapses.push_back({ from, to, quadric.Error(p + to * 3) });
+          }
+        }
+      }
+
+      std::sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs) {
+        return lhs.error < rhs.error;
+        });
+
+      // Triangles around each vertex, for flip checks
+      std::fill(adjacency_offsets.begin(), adjacency_offsets.end(), 0);
+      for (auto index : indices)
+        adjacency_offsets[index + 1]++;
+      std::partial_sum(adjacency_offsets.begin(), adjacency_offsets.end(), adjacency_offsets.begin());
+      adjacency.resize(indices.size());
+      {
+        std::vector<uint32_t> cursor(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++)
+          adjacency[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+      }
+
+      std::iota(collapse_remap.begin(), collapse_remap.end(), 0);
+      std::fill(touched.begin(), touched.end(), false);
+
+      // Each interior collapse removes two triangles
+      const auto num_triangles = indices.size() / 3;
+      const auto target_triangles = target_index_count / 3;
+      const auto collapse_goal = std::max<size_t>((num_triangles - target_triangles) / 2, 1);
+      size_t num_collapses = 0;
+
+      for (const auto& collapse : collapses)
+      {
+        if (collapse.error > max_error_squared)
+          break;
+
+        if (touched[collapse.from] || touched[collapse.to])
+          continue;
+
+        if (Flips(p, indices, adjacency_offsets, adjacency, collapse.from, collapse.to))
+          continue;
+
+        collapse_remap[collapse.from] = collapse.to;
+        quadrics[wedges[collapse.to]] += quadrics[wedges[collapse.from]];
+        result_error_squared = std::max(result_error_squared, collapse.error);
+
+        // Lock the one-ring for the rest of the pass, so that flip checks stay valid
+        for (auto k = adjacency_offsets[collapse.from]; k < adjacency_offsets[collapse.from + 1]; k++)
+        {
+          const auto t = adjacency[k];
+          for (int e = 0; e < 3; e++)
+            touched[indices[t * 3 + e]] = true;
+        }
+
+        if (++num_collapses >= collapse_goal)
+          break;
+      }
+
+      if (num_collapses == 0)
+      {
+        stuck = true;
+        continue;
+      }
+
+      // Drop degenerate triangles
+      size_t count = 0;
+      for (size_t t = 0; t < indices.size(); t += 3)
+      {
+        const auto a = collapse_remap[indices[t]];
+        const auto b = collapse_remap[indices[t + 1]];
+        const auto c = collapse_remap[indices[t + 2]];
+        if (a == b || b == c || c == a)
+          continue;
+
+        indices[count++] = a;
+        indices[count++] = b;
+        indices[count++] = c;
+      }
+      indices.resize(count);
+    }
+
+    return levels;
+  }
+
+  // True if moving from onto to would flip or degenerate a remaining triangle around from
+  static bool Flips(const float* p, const std::vector<uint32_t>& indices, const std::vector<uint32_t>& adjacency_offsets, const std::vector<uint32_t>& adjacency, uint32_t from, uint32_t to)
+  {
+    for (auto k = adjacency_offsets[from]; k < adjacency_offsets[from + 1]; k++)
+    {
+      const auto* triangle = indices.data() + adjacency[k] * 3;
+      if (triangle[0] == to || triangle[1] == to || triangle[2] == to)
+        continue;
+
+      // Rotate so that from is the first vertex
+      const auto e = triangle[0] == from ? 0 : triangle[1] == from ? 1 : 2;
+      const auto* b = p + triangle[(e + 1) % 3] * 3;
+      const auto* c = p + triangle[(e + 2) % 3] * 3;
+
+      const auto before = Cross(Subtract(b, p + from * 3), Subtract(c, p + from * 3));
+      const auto after = Cross(Subtract(b, p + to * 3), Subtract(c, p + to * 3));
+      if (Dot(before, after) <= 0.)
+        return true;
+    }
+    return false;
+  }
+
+  float lod_ratio_ = 0.5f;
+  int max_lods_ = 4;
+  float max_error_ = 0.01f;
+};
+
+MeshSimplifier::MeshSimplifier()
+{
+  impl_ = std::make_unique<Impl>();
+}
+
+MeshSimplifier::~MeshSimplifier() = default;
+
+void MeshSimplifier::SetLodRatio(float lod_ratio)
+{
+  impl_->SetLodRatio(lod_ratio);
+}
+
+void MeshSimplifier::SetMaxLods(int max_lods)
+{
+  impl_->SetMaxLods(max_lods);
+}
+
+void MeshSimplifier::SetMaxError(float max_error)
+{
+  impl_->SetMaxError(max_error);
+}
+
+std::vector<uint32_t> MeshSimplifier::Simplify(const Mesh& mesh, const std::vector<uint32_t>& indices, size_t target_index_count, float* error) const
+{
+  return impl_->Simplify(mesh, indices, target_index_count, error);
+}
+
+void MeshSimplifier::GenerateLods(Mesh& mesh) const
+{
+  impl_->GenerateLods(mesh);
+}
+}
+}
@@ -0,0 +1,46 @@
+#ifndef TWOPI_GEOMETRY_MESH_SIMPLIFIER_H_
+#define TWOPI_GEOMETRY_MESH_SIMPLIFIER_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace twopi
+{
+namespace geometry
+{
+class Mesh;
+
+// Quadric error edge collapse [Garland and Heckbert 1997] on index buffers.
+// Vertices collapse onto existing vertices, so simplified levels share the vertex buffer of the mesh.
+// Attribute seams are locked and open borders only collapse along themselves.
+class MeshSimplifier
+{
+public:
+  MeshSimplifier();
+  ~MeshSimplifier();
+
+  // Triangle count ratio between consecutive levels, 0.5 by default
+  void SetLodRatio(float lod_ratio);
+
+  // Maximum number of levels below full resolution, 4 by default
+  void SetMaxLods(int max_lods);
+
+  // Maximum error relative to the bounding box diagonal, 0.01 by default
+  void SetMaxError(float max_error);
+
+  // Collapses edges until at most target_index_count indices remain or the error bound is reached.
+  // error receives the object space error of the result.
+  std::vector<uint32_t> Simplify(const Mesh& mesh, const std::vector<uint32_t>& indices, size_t target_index_count, float* error = nullptr) const;
+
+  // Replaces Mesh::Lods with a chain simplified from the full resolution indices
+  void GenerateLods(Mesh& mesh) const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+}
+}
+
+#endif // TWOPI_GEOMETRY_MESH_SIMPLIFIER_H_
@@ -0,0 +1,352 @@
+#include <twopi/geometry/mesh_welder.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <twopi/core/thread_pool.h>
+#include <twopi/geometry/mesh.h>
+
+namespace twopi
+{
+namespace geometry
+{
+namespace
+{
+constexpr uint32_t empty_slot = ~0u;
+
+// Meshes below this size are welded in a single slab on the calling thread
+constexpr size_t min_vertices_per_slab = 16384;
+
+// A vertex attribute array of either floats or raw 16-bit words (compressed layout)
+struct Stream
+{
+  const float* floats = nullptr;
+  const uint16_t* words = nullptr;
+  int size = 0;
+  int stride = 0;
+};
+
+uint64_t HashKey(const uint32_t* key, int key_size)
+{
+  uint64_t hash = 0;
+  for (int i = 0; i < key_size; i++)
+    hash = (hash ^ key[i]) * 0x9e3779b97f4a7c15ull;
+  return hash ^ (hash >> 29);
+}
+
+uint64_t NextPowerOfTwo(uint64_t value)
+{
+  uint64_t result = 1;
+  while (result < value)
+    result <<= 1;
+  return result;
+}
+
+template <typename T>
+std::vector<T> CompactVertices(const std::vector<T>& vertices, int stride, const std::vector<uint32_t>& remap, uint32_t num_unique_vertices)
+{
+  if (vertices.empty())
+    return {};
+
+  // New indices are assigned in first-occurrence order, so each is written once by its first vertex
+  std::vector<T> compacted(static_cast<size_t>(num_unique_vertices) * stride);
+  uint32_t next = 0;
+  for (size_t i = 0; i < remap.size(); i++)
+  {
+    if (remap[i] == next)
+    {
+      std::copy_n(vertices.data() + i * stride, stride, compacted.data() + static_cast<size_t>(next) * stride);
+      next++;
+    }
+  }
+  return compacted;
+}
+}
+
+class MeshWelder::Impl
+{
+public:
+  Impl()
+  {
+  }
+
+  explicit Impl(core::ThreadPool& thread_pool)
+    : thread_pool_(thread_pool)
+  {
+  }
+
+  ~Impl() = default;
+
+  void SetEpsilon(float epsilon)
+  {
+    epsilon_ = std::max(epsilon, 0.f);
+  }
+
+  void Weld(Mesh& mesh) const
+  {
+    const auto num_vertices = static_cast<size_t>(mesh.NumVertices());
+    if (num_vertices == 0)
+      return;
+
+    std::vector<Stream> streams;
+    if (mesh.IsCompressed())
+      streams.push_back({ nullptr, mesh.CompressedVertices().data(), Mesh::compressed_stride, Mesh::compressed_stride });
+    else if (mesh.IsInterleaved())
+      streams.push_back({ mesh.InterleavedVertices().data(), nullptr, Mesh::interleaved_stride, Mesh::interleaved_stride });
+    else
+    {
+      streams.push_back({ mesh.Vertices().data(), nullptr, 3, 3 });
+      if (!mesh.Normals().empty())
+        streams.push_back({ mesh.Normals().data(), nullptr, 3, 3 });
+      if (!mesh.TexCoords().empty())
+        streams.push_back({ mesh.TexCoords().data(), nullptr, 2, 2 });
+    }
+
+    // Tangents are planar in every layout
+    if (!mesh.Tangents().empty())
+      streams.push_back({ mesh.Tangents().data(), nullptr, 4, 4 });
+
+    std::vector<uint32_t> remap;
+    const auto num_unique_vertices = BuildRemap(streams, num_vertices, remap);
+
+    auto indices = mesh.Indices();
+    if (num_unique_vertices == num_vertices && !indices.empty())
+      return;
+
+    if (indices.empty())
+      indices = remap;
+    else
+    {
+      for (auto& index : indices)
+        index = remap[index];
+    }
+
+    mesh.SetVertices(CompactVertices(mesh.Vertices(), 3, remap, num_unique_vertices));
+    mesh.SetNormals(CompactVertices(mesh.Normals(), 3, remap, num_unique_vertices));
+    mesh.SetTexCoords(CompactVertices(mesh.TexCoords(), 2, remap, num_unique_vertices));
+    mesh.SetTangents(CompactVertices(mesh.Tangents(), 4, remap, num_unique_vertices));
+    mesh.SetInterleavedVertices(CompactVertices(mesh.InterleavedVertices(), Mesh::interleaved_stride, remap, num_unique_vertices));
+    mesh.SetCompressedVertices(CompactVertices(mesh.CompressedVertices(), Mesh::compressed_stride, remap, num_unique_vertices));
+    mesh.SetIndices(std::move(indices));
+
+    auto lods = mesh.Lods();
+    for (auto& lod : lods)
+    {
+      for (auto& index : lod.indices)
+        index = remap[index];
+    }
+    mesh.SetLods(std::move(lods));
+  }
+
+  uint32_t BuildRemap(const float* vertices, size_t num_vertices, int stride, std::vector<uint32_t>& remap) const
+  {
+    return BuildRemap({ { vertices, nullptr, stride, stride } }, num_vertices, remap);
+  }
+
+private:
+  uint32_t KeyComponent(float value) const
+  {
+    if (epsilon_ > 0.f)
+    {
+      // Clamped to int32 before the cast, which is undefined out of range; NaN goes to the lowest cell
+      constexpr auto cell_min = static_cast<double>(std::numeric_limits<int32_t>::min());
+      constexpr auto cell_max = static_cast<double>(std::numeric_limits<int32_t>::max());
+      const auto cell = std::floor(static_cast<double>(value) / epsilon_);
+      return static_cast<uint32_t>(static_cast<int32_t>(cell >= cell_min ? std::min(cell, cell_max) : cell_min));
+    }
+
+    // Bit pattern, with -0 and +0 merged
+    if (value == 0.f)
+      return 0;
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof bits);
+    return bits;
+  }
+
+  // Monotonic in the spatial coordinate, and equal for equal key components
+  float KeyCoordinate(const Stream& stream, uint32_t key_component) const
+  {
+    if (stream.words != nullptr)
+      return static_cast<float>(key_component);
+    if (epsilon_ > 0.f)
+      return static_cast<float>(static_cast<int32_t>(key_component));
+
+    float value;
+    std::memcpy(&value, &key_component, sizeof value);
+    return value;
+  }
+
+  uint32_t BuildRemap(const std::vector<Stream>& streams, size_t num_vertices, std::vector<uint32_t>& remap) const
+  {
+    int key_size = 0;
+    for (const auto& stream : streams)
+      key_size += stream.size;
+
+    // Quantized keys
+    std::vector<uint32_t> keys(num_vertices * key_size);
+    const auto build_keys = [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++)
+      {
+        auto* key = keys.data() + i * key_size;
+        for (const auto& stream : streams)
+        {
+          for (int j = 0; j < stream.size; j++)
+          {
+            const auto element = i * stream.stride + j;
+            *key++ = stream.words != nullptr ? stream.words[element] : KeyComponent(stream.floats[element]);
+          }
+        }
+      }
+    };
+
+    const auto num_slabs = std::min<size_t>(
+      std::max<size_t>(num_vertices / min_vertices_per_slab, 1),
+      static_cast<size_t>(thread_pool_->NumThreads()) * 2);
+
+    if (num_slabs > 1)
+      thread_pool_->ParallelFor(num_vertices, build_keys);
+    else
+      build_keys(0, num_vertices);
+
+    // Spatial slabs along the longest axis of the first stream, so that equal keys always share a slab
+    std::vector<uint32_t> slab_offsets(num_slabs + 1, 0);
+    std::vector<uint32_t> slab_vertices(num_vertices);
+    if (num_slabs > 1)
+    {
+      const auto& stream = streams[0];
+      const auto num_axes = std::min(stream.size, 3);
+
+      std::vector<float> coordinate_min(num_axes, std::numeric_limits<float>::max());
+      std::vector<float> coordinate_max(num_axes, std::numeric_limits<float>::lowest());
+      for (size_t i = 0; i < num_vertices; i++)
+      {
+        for (int j = 0; j < num_axes; j++)
+        {
+          const auto coordinate = KeyCoordinate(stream, keys[i * key_size + j]);
+          coordinate_min[j] = std::min(coordinate_min[j], coordinate);
+          coordinate_max[j] = std::max(coordinate_max[j], coordinate);
+        }
+      }
+
+      int axis = 0;
+      for (int j = 1; j < num_axes; j++)
+      {
+        if (coordinate_max[j] - coordinate_min[j] > coordinate_max[axis] - coordinate_min[axis])
+          axis = j;
+      }
+
+      const auto extent = coordinate_max[axis] - coordinate_min[axis];
+      const auto slab_scale = extent > 0.f ? num_slabs / extent : 0.f;
+
+      std::vector<uint32_t> vertex_slabs(num_vertices);
+      for (size_t i = 0; i < num_vertices; i++)
+      {
+        const auto coordinate = KeyCoordinate(stream, keys[i * key_size + axis]);
+        const auto slab = std::min(static_cast<size_t>((coordinate - coordinate_min[axis]) * slab_scale), num_slabs - 1);
+        vertex_slabs[i] = static_cast<uint32_t>(slab);
+        slab_offsets[slab + 1]++;
+      }
+
+      for (size_t s = 0; s < num_slabs; s++)
+        slab_offsets[s + 1] += slab_offsets[s];
+
+      // Counting sort keeps vertices ascending within each slab
+      std::vector<uint32_t> cursor(slab_offsets.begin(), slab_offsets.end() - 1);
+      for (size_t i = 0; i < num_vertices; i++)
+        slab_vertices[cursor[vertex_slabs[i]]++] = static_cast<uint32_t>(i);
+    }
+    else
+    {
+      slab_offsets[1] = static_cast<uint32_t>(num_vertices);
+      for (size_t i = 0; i < num_vertices; i++)
+        slab_vertices[i] = static_cast<uint32_t>(i);
+    }
+
+    // First occurrence of each key, with an open addressing table per slab
+    std::vector<uint32_t> representatives(num_vertices);
+    const auto weld_slabs = [&](size_t begin, size_t end) {
+      std::vector<uint32_t> table;
+      for (size_t s = begin; s < end; s++)
+      {
+        const auto count = slab_offsets[s + 1] - slab_offsets[s];
+        const auto table_size = NextPowerOfTwo(static_cast<uint64_t>(count) * 2);
+        const auto mask = table_size - 1;
+        table.assign(table_size, empty_slot);
+
+        for (auto k = slab_offsets[s]; k < slab_offsets[s + 1]; k++)
+        {
+          const auto vertex = slab_vertices[k];
+          const auto* key = keys.data() + static_cast<size_t>(vertex) * key_size;
+
+          auto slot = HashKey(key, key_size) & mask;
+          while (true)
+          {
+            const auto other = table[slot];
+            if (other == empty_slot)
+            {
+              table[slot] = vertex;
+              representatives[vertex] = vertex;
+              break;
+            }
+
+            if (std::equal(key, key + key_size, keys.data() + static_cast<size_t>(other) * key_size))
+            {
+              representatives[vertex] = other;
+              break;
+            }
+
+            slot = (slot + 1) & mask;
+          }
+        }
+      }
+    };
+
+    if (num_slabs > 1)
+      thread_pool_->ParallelFor(num_slabs, weld_slabs);
+    else
+      weld_slabs(0, 1);
+
+    // Representatives precede their duplicates, so new indices follow first-occurrence order
+    remap.resize(num_vertices);
+    uint32_t num_unique_vertices = 0;
+    for (size_t i = 0; i < num_vertices; i++)
+      remap[i] = representatives[i] == i ? num_unique_vertices++ : remap[representatives[i]];
+
+    return num_unique_vertices;
+  }
+
+  float epsilon_ = 0.f;
+
+  mutable core::LazyThreadPool thread_pool_;
+};
+
+MeshWelder::MeshWelder()
+{
+  impl_ = std::make_unique<Impl>();
+}
+
+MeshWelder::MeshWelder(core::ThreadPool& thread_pool)
+{
+  impl_ = std::make_unique<Impl>(thread_pool);
+}
+
+MeshWelder::~MeshWelder() = default;
+
+void MeshWelder::SetEpsilon(float epsilon)
+{
+  impl_->SetEpsilon(epsilon);
+}
+
+void MeshWelder::Weld(Mesh& mesh) const
+{
+  impl_->Weld(mesh);
+}
+
+uint32_t MeshWelder::BuildRemap(const float* vertices, size_t num_vertices, int stride, std::vector<uint32_t>& remap) const
+{
+  return impl_->BuildRemap(vertices, num_vertices, stride, remap);
+}
+}
+}
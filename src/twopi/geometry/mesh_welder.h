@@ -0,0 +1,49 @@
+#ifndef TWOPI_GEOMETRY_MESH_WELDER_H_
+#define TWOPI_GEOMETRY_MESH_WELDER_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace twopi
+{
+namespace core
+{
+class ThreadPool;
+}
+
+namespace geometry
+{
+class Mesh;
+
+// Merges duplicate vertices, e.g. OBJ faces that repeat shared corners.
+// Vertices are hashed on quantized attributes into open addressing tables, one per spatial slab, in parallel.
+class MeshWelder
+{
+public:
+  MeshWelder();
+
+  // Hashes and welds on thread_pool, e.g. the pool of a MeshLoader, instead of creating one on first use
+  explicit MeshWelder(core::ThreadPool& thread_pool);
+
+  ~MeshWelder();
+
+  // Quantization step of float attributes; vertices in the same cell are merged.
+  // 0 (default) merges bitwise equal vertices only.
+  void SetEpsilon(float epsilon);
+
+  // Welds every vertex layout of the mesh and rewrites its indices. Non-indexed meshes become indexed.
+  void Weld(Mesh& mesh) const;
+
+  // remap[i] is the welded index of vertex i, for num_vertices vertices of stride floats.
+  // Unique vertices keep their first-occurrence order. Returns the number of unique vertices.
+  uint32_t BuildRemap(const float* vertices, size_t num_vertices, int stride, std::vector<uint32_t>& remap) const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+}
+}
+
+#endif // TWOPI_GEOMETRY_MESH_WELDER_H_
@@ -0,0 +1,330 @@
+#include <twopi/geometry/meshlet_builder.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <twopi/geometry/mesh.h>
+
+namespace twopi
+{
+namespace geometry
+{
+namespace
+{
+using Vector = std::array<float, 3>;
+
+Vector Subtract(const Vector& a, const Vector& b)
+{
+  return { a[0] - b[0], a[1] - b[1], a[2] - b[2] };
+}
+
+float Dot(const Vector& a, const Vector& b)
+{
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+Vector Cross(const Vector& a, const Vector& b)
+{
+  return { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+}
+
+float Length(const Vector& v)
+{
+  return std::sqrt(Dot(v, v));
+}
+}
+
+class MeshletBuilder::Impl
+{
+public:
+  Impl()
+  {
+  }
+
+  ~Impl() = default;
+
+  void SetMaxVertices(int max_vertices)
+  {
+    max_vertices_ = std::max(max_vertices, 3);
+  }
+
+  void SetMaxTriangles(int max_triangles)
+  {
+    max_triangles_ = std::max(max_triangles, 1);
+  }
+
+  void Build(Mesh& mesh) const
+  {
+    const auto& indices = mesh.Indices();
+    const auto num_vertices = static_cast<size_t>(mesh.NumVertices());
+    const auto num_triangles = indices.size() / 3;
+    if (num_triangles == 0 || indices.size() % 3 != 0)
+      return;
+
+    const auto positions = mesh.Positions();
+    const auto position = [&positions](uint32_t vertex) {
+      return Vector{ positions[vertex * 3 + 0], positions[vertex * 3 + 1], positions[vertex * 3 + 2] };
+    };
+
+    // Triangles around each vertex
+    std::vector<uint32_t> vertex_offsets(num_vertices + 1, 0);
+    for (auto index : indices)
+      vertex_offsets[index + 1]++;
+    for (size_t i = 0; i < num_vertices; i++)
+      vertex_offsets[i + 1] += vertex_offsets[i];
+
+    std::vector<uint32_t> vertex_triangles(indices.size());
+    {
+      std::vector<uint32_t> cursor(vertex_offsets.begin(), vertex_offsets.end() - 1);
+      for (size_t i = 0; i < indices.size(); i++)
+        vertex_triangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    std::vector<Vector> triangle_centers(num_triangles);
+    for (size_t t = 0; t < num_triangles; t++)
+    {
+      const auto p0 = position(indices[t * 3 + 0]);
+      const auto p1 = position(indices[t * 3 + 1]);
+      const auto p2 = position(indices[t * 3 + 2]);
+      for (int j = 0; j < 3; j++)
+        triangle_centers[t][j] = (p0[j] + p1[j] + p2[j]) / 3.f;
+    }
+
+    std::vector<bool> emitted(num_triangles, false);
+    // Meshlet that last referenced each vertex, to count new vertices of a candidate triangle
+    std::vector<uint32_t> vertex_meshlet(num_vertices, std::numeric_limits<uint32_t>::max());
+
+    std::vector<uint32_t> meshlet_indices;
+    meshlet_indices.reserve(indices.size());
+    std::vector<Meshlet> meshlets;
+
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> triangles;
+    size_t scan = 0;
+    while (true)
+    {
+      // Seed with a triangle adjacent to the previous meshlet, otherwise the next one in index order
+      uint32_t seed = std::numeric_limits<uint32_t>::max();
+      for (auto candidate : candidates)
+      {
+        if (!emitted[candidate])
+        {
+          seed = candidate;
+          break;
+        }
+      }
+
+      if (seed == std::numeric_limits<uint32_t>::max())
+      {
+        while (scan < num_triangles && emitted[scan])
+          scan++;
+        if (scan == num_triangles)
+          break;
+        seed = static_cast<uint32_t>(scan);
+      }
+
+      const auto meshlet_id = static_cast<uint32_t>(meshlets.size());
+      int meshlet_vertices = 0;
+      Vector centroid{ 0.f, 0.f, 0.f };
+      triangles.clear();
+      candidates.clear();
+
+      auto triangle = seed;
+      while (true)
+      {
+        emitted[triangle] = true;
+        triangles.push_back(triangle);
+        for (int j = 0; j < 3; j++)
+        {
+          const auto vertex = indices[triangle * 3 + j];
+          if (vertex_meshlet[vertex] != meshlet_id)
+          {
+            vertex_meshlet[vertex] = meshlet_id;
+            meshlet_vertices++;
+          }
+
+          for (auto k = vertex_offsets[vertex]; k < vertex_offsets[vertex + 1]; k++)
+          {
+            if (!emitted[vertex_triangles[k]])
+              candidates.push_back(vertex_triangles[k]);
+          }
+        }
+
+        const auto weight = 1.f / triangles.size();
+        for (int j = 0; j < 3; j++)
+          centroid[j] += (triangle_centers[triangle][j] - centroid[j]) * weight;
+
+        if (static_cast<int>(triangles.size()) == max_triangles_)
+          break;
+
+        // Fewest new vertices first, then closest to the meshlet
+        uint32_t best = std::numeric_limits<uint32_t>::max();
+        int best_new_vertices = 3;
+        float best_distance = std::numeric_limits<float>::max();
+        size_t num_candidates = 0;
+        for (auto candidate : candidates)
+        {
+          if (emitted[candidate])
+            continue;
+          candidates[num_candidates++] = candidate;
+
+          int new_vertices = 0;
+          for (int j = 0; j < 3; j++)
+          {
+            if (vertex_meshlet[indices[candidate * 3 + j]] != meshlet_id)
+              new_vertices++;
+          }
+
+          if (meshlet_vertices + new_vertices > max_vertices_)
+            continue;
+
+          const auto offset = Subtract(triangle_centers[candidate], centroid);
+          const auto distance = Dot(offset, offset);
+          if (new_vertices < best_new_vertices || (new_vertices == best_new_vertices && distance < best_distance))
+          {
+            best = candidate;
+            best_new_vertices = new_vertices;
+            best_distance = distance;
+          }
+        }
+        candidates.resize(num_candidates);
+
+        if (best == std::numeric_limits<uint32_t>::max())
+          break;
+        triangle = best;
+      }
+
+      Meshlet meshlet;
+      meshlet.first_index = static_cast<uint32_t>(meshlet_indices.size());
+      meshlet.num_indices = static_cast<uint32_t>(triangles.size() * 3);
+      meshlet.num_vertices = meshlet_vertices;
+      for (auto t : triangles)
+      {
+        for (int j = 0; j < 3; j++)
+          meshlet_indices.push_back(indices[t * 3 + j]);
+      }
+
+      ComputeBounds(positions, meshlet_indices.data() + meshlet.first_index, meshlet.num_indices, meshlet);
+      meshlets.push_back(meshlet);
+    }
+
+    mesh.SetIndices(std::move(meshlet_indices));
+    mesh.SetMeshlets(std::move(meshlets));
+  }
+
+private:
+  static void ComputeBounds(const std::vector<float>& positions, const uint32_t* indices, uint32_t num_indices, Meshlet& meshlet)
+  {
+    const auto position = [&positions](uint32_t vertex) {
+      return Vector{ positions[vertex * 3 + 0], positions[vertex * 3 + 1], positions[vertex * 3 + 2] };
+    };
+
+    // Bounding sphere around the box center
+    Vector box_min{ std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+    Vector box_max{ std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+    for (uint32_t i = 0; i < num_indices; i++)
+    {
+      const auto p = position(indices[i]);
+      for (int j = 0; j < 3; j++)
+      {
+        box_min[j] = std::min(box_min[j], p[j]);
+        box_max[j] = std::max(box_max[j], p[j]);
+      }
+    }
+
+    for (int j = 0; j < 3; j++)
+      meshlet.center[j] = (box_min[j] + box_max[j]) * 0.5f;
+
+    float radius = 0.f;
+    for (uint32_t i = 0; i < num_indices; i++)
+      radius = std::max(radius, Length(Subtract(position(indices[i]), meshlet.center)));
+    meshlet.radius = radius;
+
+    // Normal cone from unit face normals; degenerate triangles do not constrain it
+    std::vector<Vector> normals;
+    normals.reserve(num_indices / 3);
+    Vector axis{ 0.f, 0.f, 0.f };
+    for (uint32_t i = 0; i < num_indices; i += 3)
+    {
+      const auto p0 = position(indices[i + 0]);
+      const auto normal = Cross(Subtract(position(indices[i + 1]), p0), Subtract(position(indices[i + 2]), p0));
+      const auto length = Length(normal);
+      if (length == 0.f)
+      {
+        normals.push_back({ 0.f, 0.f, 0.f });
+        continue;
+      }
+
+      normals.push_back({ normal[0] / length, normal[1] / length, normal[2] / length });
+      for (int j = 0; j < 3; j++)
+        axis[j] += normals.back()[j];
+    }
+
+    meshlet.cone_apex = meshlet.center;
+    meshlet.cone_axis = { 0.f, 0.f, 0.f };
+    meshlet.cone_cutoff = 1.f;
+
+    const auto axis_length = Length(axis);
+    if (axis_length == 0.f)
+      return;
+    for (int j = 0; j < 3; j++)
+      axis[j] /= axis_length;
+
+    float min_dot = 1.f;
+    for (const auto& normal : normals)
+    {
+      if (normal[0] != 0.f || normal[1] != 0.f || normal[2] != 0.f)
+        min_dot = std::min(min_dot, Dot(normal, axis));
+    }
+
+    // Normals spread over a hemisphere or more: some triangle always faces the viewer
+    if (min_dot <= 0.f)
+      return;
+
+    // Apex behind every triangle plane along the axis, so that the cone contains the whole cluster
+    float max_t = 0.f;
+    for (uint32_t i = 0; i < num_indices; i += 3)
+    {
+      const auto& normal = normals[i / 3];
+      const auto d = Dot(normal, axis);
+      if (d <= 0.f)
+        continue;
+      max_t = std::max(max_t, Dot(Subtract(meshlet.center, position(indices[i])), normal) / d);
+    }
+
+    for (int j = 0; j < 3; j++)
+      meshlet.cone_apex[j] = meshlet.center[j] - axis[j] * max_t;
+    meshlet.cone_axis = axis;
+    meshlet.cone_cutoff = std::sqrt(1.f - min_dot * min_dot);
+  }
+
+  int max_vertices_ = 64;
+  int max_triangles_ = 124;
+};
+
+MeshletBuilder::MeshletBuilder()
+{
+  impl_ = std::make_unique<Impl>();
+}
+
+MeshletBuilder::~MeshletBuilder() = default;
+
+void MeshletBuilder::SetMaxVertices(int max_vertices)
+{
+  impl_->SetMaxVertices(max_vertices);
+}
+
+void MeshletBuilder::SetMaxTriangles(int max_triangles)
+{
+  impl_->SetMaxTriangles(max_triangles);
+}
+
+void MeshletBuilder::Build(Mesh& mesh) const
+{
+  impl_->Build(mesh);
+}
+}
+}
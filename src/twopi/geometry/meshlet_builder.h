@@ -0,0 +1,36 @@
+#ifndef TWOPI_GEOMETRY_MESHLET_BUILDER_H_
+#define TWOPI_GEOMETRY_MESHLET_BUILDER_H_
+
+#include <memory>
+
+namespace twopi
+{
+namespace geometry
+{
+class Mesh;
+
+// Partitions the triangles of a mesh into meshlets of bounded vertex and triangle counts, grown greedily
+// over shared vertices. Indices are reordered so that each meshlet is a contiguous index range.
+class MeshletBuilder
+{
+public:
+  MeshletBuilder();
+  ~MeshletBuilder();
+
+  // Maximum number of unique vertices per meshlet, 64 by default
+  void SetMaxVertices(int max_vertices);
+
+  // Maximum number of triangles per meshlet, 124 by default
+  void SetMaxTriangles(int max_triangles);
+
+  // Replaces Mesh::Meshlets and reorders Mesh::Indices into meshlet order
+  void Build(Mesh& mesh) const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+}
+}
+
+#endif // TWOPI_GEOMETRY_MESHLET_BUILDER_H_
@@ -0,0 +1,325 @@
+#include <twopi/geometry/mipmap_generator.h>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TWOPI_GEOMETRY_MIPMAP_GENERATOR_SSE2
+#include <emmintrin.h>
+#endif
+
+#include <twopi/core/thread_pool.h>
+#include <twopi/geometry/image.h>
+
+namespace twopi
+{
+namespace geometry
+{
+namespace
+{
+constexpr float pi = 3.14159265358979f;
+
+// Kaiser window parameters: width in destination pixels, and the window shape
+constexpr float kaiser_width = 3.f;
+constexpr float kaiser_alpha = 4.f;
+
+// Linear values are quantized to 16 bits for the encoding table
+constexpr int linear_table_size = 65536;
+
+float SrgbToLinear(float value)
+{
+  return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+float LinearToSrgb(float value)
+{
+  return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.f / 2.4f) - 0.055f;
+}
+
+struct SrgbTables
+{
+  float to_linear[256];
+  uint8_t to_srgb[linear_table_size];
+
+  SrgbTables()
+  {
+    for (int i = 0; i < 256; i++)
+      to_linear[i] = SrgbToLinear(i / 255.f);
+    for (int i = 0; i < linear_table_size; i++)
+      to_srgb[i] = static_cast<uint8_t>(LinearToSrgb(static_cast<float>(i) / (linear_table_size - 1)) * 255.f + 0.5f);
+  }
+};
+
+const SrgbTables& Tables()
+{
+  static const SrgbTables tables;
+  return tables;
+}
+
+// Zeroth order modified Bessel function of the first kind
+float BesselI0(float x)
+{
+  float sum = 1.f;
+  float term = 1.f;
+  for (int k = 1; k < 32; k++)
+  {
+    term *= (x / (2.f * k)) * (x / (2.f * k));
+    sum += term;
+    if (term < sum * 1e-8f)
+      break;
+  }
+  return sum;
+}
+
+float Sinc(float x)
+{
+  if (std::abs(x) < 1e-6f)
+    return 1.f;
+  return std::sin(pi * x) / (pi * x);
+}
+
+// Source taps of one destination pixel along an axis
+struct Taps
+{
+  int first = 0;
+  std::vector<float> weights;
+};
+
+// Taps of every destination pixel, reducing src to dst pixels. Taps outside the source are clamped to the edges.
+std::vector<Taps> ComputeTaps(int src, int dst, MipmapFilter filter)
+{
+  std::vector<Taps> taps(dst);
+  const auto scale = static_cast<float>(src) / dst;
+  for (int i = 0; i < dst; i++)
+  {
+    // Weights of source pixels before clamping
+    int first;
+    std::vector<float> weights;
+    if (filter == MipmapFilter::BOX)
+    {
+      first = std::min(i * 2, src - 1);
+      weights = { 0.5f, 0.5f };
+    }
+    else
+    {
+      const auto center = (i + 0.5f) * scale - 0.5f;
+      const auto radius = kaiser_width * 0.5f * scale;
+      first = static_cast<int>(std::ceil(center - radius));
+      const auto last = static_cast<int>(std::floor(center + radius));
+      for (int x = first; x <= last; x++)
+      {
+        const auto t = (x - center) / scale;
+        const auto u = t / (kaiser_width * 0.5f);
+        weights.push_back(Sinc(t) * BesselI0(kaiser_alpha * std::sqrt(std::max(0.f, 1.f - u * u))) / BesselI0(kaiser_alpha));
+      }
+    }
+
+    // Clamped taps accumulate onto the edge pixels
+    const auto clamped_first = std::clamp(first, 0, src - 1);
+    const auto clamped_last = std::clamp(first + static_cast<int>(weights.size()) - 1, 0, src - 1);
+    taps[i].first = clamped_first;
+    taps[i].weights.assign(clamped_last - clamped_first + 1, 0.f);
+    float sum = 0.f;
+    for (int k = 0; k < weights.size(); k++)
+    {
+      taps[i].weights[std::clamp(first + k, 0, src - 1) - clamped_first] += weights[k];
+      sum += weights[k];
+    }
+    for (auto& weight : taps[i].weights)
+      weight /= sum;
+  }
+  return taps;
+}
+
+// dst += weight * src over one RGBA pixel
+inline void Accumulate(float* dst, const float* src, float weight)
+{
+#ifdef TWOPI_GEOMETRY_MIPMAP_GENERATOR_SSE2
+  _mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(_mm_loadu_ps(src), _mm_set1_ps(weight))));
+#else
+  for (int c = 0; c < 4; c++)
+    dst[c] += src[c] * weight;
+#endif
+}
+}
+
+class MipmapGenerator::Impl
+{
+public:
+  Impl()
+  {
+  }
+
+  explicit Impl(core::ThreadPool& thread_pool)
+    : thread_pool_(thread_pool)
+  {
+  }
+
+  ~Impl() = default;
+
+  void SetFilter(MipmapFilter filter)
+  {
+    filter_ = filter;
+  }
+
+  void SetSrgb(bool srgb)
+  {
+    srgb_ = srgb;
+  }
+
+  std::vector<std::shared_ptr<Image<uint8_t>>> Generate(std::shared_ptr<Image<uint8_t>> image) const
+  {
+    std::vector<std::shared_ptr<Image<uint8_t>>> levels{ image };
+
+    auto width = image->Width();
+    auto height = image->Height();
+    const auto comp = image->Comp();
+    if (width <= 0 || height <= 0 || comp <= 0 || comp > 4)
+      return levels;
+
+    // Each level is filtered from the previous one at full precision, not from its quantized pixels
+    auto pixels = ToLinear(*image);
+    while (width > 1 || height > 1)
+    {
+      const auto next_width = std::max(width / 2, 1);
+      const auto next_height = std::max(height / 2, 1);
+      pixels = Reduce(pixels, width, height, next_width, next_height);
+      width = next_width;
+      height = next_height;
+
+      auto level = std::make_shared<Image<uint8_t>>(width, height, comp);
+      FromLinear(pixels, *level);
+      levels.push_back(level);
+    }
+
+    return levels;
+  }
+
+private:
+  // Four floats per pixel, unused components zero
+  std::vector<float> ToLinear(const Image<uint8_t>& image) const
+  {
+    const auto num_pixels = static_cast<size_t>(image.Width()) * image.Height();
+    const auto comp = image.Comp();
+    const auto* data = image.Data();
+    const auto& tables = Tables();
+
+    std::vector<float> pixels(num_pixels * 4, 0.f);
+    thread_pool_->ParallelFor(num_pixels, [&](size_t begin, size_t end) {
+      for (auto i = begin; i < end; i++)
+      {
+        for (int c = 0; c < comp; c++)
+        {
+          const auto value = data[i * comp + c];
+          pixels[i * 4 + c] = IsColor(c, comp) ? tables.to_linear[value] : value / 255.f;
+        }
+      }
+      });
+    return pixels;
+  }
+
+  void FromLinear(const std::vector<float>& pixels, Image<uint8_t>& image) const
+  {
+    const auto num_pixels = static_cast<size_t>(image.Width()) * image.Height();
+    const auto comp = image.Comp();
+    auto* data = image.Data();
+    const auto& tables = Tables();
+
+    thread_pool_->ParallelFor(num_pixels, [&](size_t begin, size_t end) {
+      for (auto i = begin; i < end; i++)
+      {
+        for (int c = 0; c < comp; c++)
+        {
+          // Windowed sinc rings, so values may leave [0, 1]
+          const auto value = std::clamp(pixels[i * 4 + c], 0.f, 1.f);
+          data[i * comp + c] = IsColor(c, comp)
+            ? tables.to_srgb[static_cast<int>(value * (linear_table_size - 1) + 0.5f)]
+            : static_cast<uint8_t>(value * 255.f + 0.5f);
+        }
+      }
+      });
+  }
+
+  // Alpha is the last channel of gray-alpha and RGBA images; every other channel is color
+  bool IsColor(int channel, int comp) const
+  {
+    if (!srgb_)
+      return false;
+    if (comp == 2 || comp == 4)
+      return channel < comp - 1;
+    return true;
+  }
+
+  // Separable filter, rows first
+  std::vector<float> Reduce(const std::vector<float>& src, int width, int height, int next_width, int next_height) const
+  {
+    const auto column_taps = ComputeTaps(width, next_width, filter_);
+    const auto row_taps = ComputeTaps(height, next_height, filter_);
+
+    std::vector<float> horizontal(static_cast<size_t>(next_width) * height * 4, 0.f);
+    thread_pool_->ParallelFor(height, [&](size_t begin, size_t end) {
+      for (auto y = begin; y < end; y++)
+      {
+        const auto* src_row = src.data() + y * width * 4;
+        auto* dst_row = horizontal.data() + y * next_width * 4;
+        for (int x = 0; x < next_width; x++)
+        {
+          const auto& taps = column_taps[x];
+          for (int k = 0; k < taps.weights.size(); k++)
+            Accumulate(dst_row + x * 4, src_row + (taps.first + k) * 4, taps.weights[k]);
+        }
+      }
+      });
+
+    std::vector<float> dst(static_cast<size_t>(next_width) * next_height * 4, 0.f);
+    thread_pool_->ParallelFor(next_height, [&](size_t begin, size_t end) {
+      for (auto y = begin; y < end; y++)
+      {
+        auto* dst_row = dst.data() + y * next_width * 4;
+        const auto& taps = row_taps[y];
+        for (int k = 0; k < taps.weights.size(); k++)
+        {
+          const auto* src_row = horizontal.data() + static_cast<size_t>(taps.first + k) * next_width * 4;
+          for (int x = 0; x < next_width; x++)
+            Accumulate(dst_row + x * 4, src_row + x * 4, taps.weights[k]);
+        }
+      }
+      });
+
+    return dst;
+  }
+
+  MipmapFilter filter_ = MipmapFilter::BOX;
+  bool srgb_ = true;
+
+  mutable core::LazyThreadPool thread_pool_;
+};
+
+MipmapGenerator::MipmapGenerator()
+{
+  impl_ = std::make_unique<Impl>();
+}
+
+MipmapGenerator::MipmapGenerator(core::ThreadPool& thread_pool)
+{
+  impl_ = std::make_unique<Impl>(thread_pool);
+}
+
+MipmapGenerator::~MipmapGenerator() = default;
+
+void MipmapGenerator::SetFilter(MipmapFilter filter)
+{
+  impl_->SetFilter(filter);
+}
+
+void MipmapGenerator::SetSrgb(bool srgb)
+{
+  impl_->SetSrgb(srgb);
+}
+
+std::vector<std::shared_ptr<Image<uint8_t>>> MipmapGenerator::Generate(std::shared_ptr<Image<uint8_t>> image) const
+{
+  return impl_->Generate(image);
+}
+}
+}
@@ -0,0 +1,56 @@
+#ifndef TWOPI_GEOMETRY_MIPMAP_GENERATOR_H_
+#define TWOPI_GEOMETRY_MIPMAP_GENERATOR_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace twopi
+{
+namespace core
+{
+class ThreadPool;
+}
+
+namespace geometry
+{
+template <typename T>
+class Image;
+
+enum class MipmapFilter
+{
+  BOX,
+  KAISER,
+};
+
+// Full mip chains of 8-bit images down to 1x1, each level filtered from the previous one in linear float space.
+// Rows are filtered in parallel, one RGBA pixel per SIMD register.
+class MipmapGenerator
+{
+public:
+  MipmapGenerator();
+
+  // Filters rows on thread_pool instead of a pool of its own
+  explicit MipmapGenerator(core::ThreadPool& thread_pool);
+
+  ~MipmapGenerator();
+
+  // BOX averages 2x2 pixels; KAISER is a Kaiser windowed sinc over 6x6 pixels, sharper at the cost of time.
+  // BOX by default.
+  void SetFilter(MipmapFilter filter);
+
+  // Decode RGB from sRGB before filtering and encode after, so that averages are of light intensity.
+  // Alpha is always linear. True by default; disable for data such as normal maps.
+  void SetSrgb(bool srgb);
+
+  // Levels from image itself, the first element, to 1x1
+  std::vector<std::shared_ptr<Image<uint8_t>>> Generate(std::shared_ptr<Image<uint8_t>> image) const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+}
+}
+
+#endif // TWOPI_GEOMETRY_MIPMAP_GENERATOR_H_
@@ -0,0 +1,101 @@
+#include <twopi/geometry/model.h>
+
+#include <twopi/geometry/mesh.h>
+#include <twopi/geometry/texture_table.h>
+
+namespace twopi
+{
+namespace geometry
+{
+class Model::Impl
+{
+public:
+  Impl()
+  {
+  }
+
+  ~Impl() = default;
+
+  void AddMesh(std::shared_ptr<Mesh> mesh)
+  {
+    meshes_.emplace_back(std::move(mesh));
+  }
+
+  void SetMeshes(std::vector<std::shared_ptr<Mesh>>&& meshes)
+  {
+    meshes_ = std::move(meshes);
+  }
+
+  int NumMeshes() const
+  {
+    return static_cast<int>(meshes_.size());
+  }
+
+  std::shared_ptr<Mesh> GetMesh(int index) const
+  {
+    return meshes_[index];
+  }
+
+  const std::vector<std::shared_ptr<Mesh>>& Meshes() const
+  {
+    return meshes_;
+  }
+
+  void SetTextures(std::shared_ptr<TextureTable> textures)
+  {
+    textures_ = std::move(textures);
+  }
+
+  std::shared_ptr<TextureTable> Textures() const
+  {
+    return textures_;
+  }
+
+private:
+  std::vector<std::shared_ptr<Mesh>> meshes_;
+  std::shared_ptr<TextureTable> textures_;
+};
+
+Model::Model()
+{
+  impl_ = std::make_unique<Impl>();
+}
+
+Model::~Model() = default;
+
+void Model::AddMesh(std::shared_ptr<Mesh> mesh)
+{
+  impl_->AddMesh(std::move(mesh));
+}
+
+void Model::SetMeshes(std::vector<std::shared_ptr<Mesh>>&& meshes)
+{
+  impl_->SetMeshes(std::move(meshes));
+}
+
+int Model::NumMeshes() const
+{
+  return impl_->NumMeshes();
+}
+
+std::shared_ptr<Mesh> Model::GetMesh(int index) const
+{
+  return impl_->GetMesh(index);
+}
+
+const std::vector<std::shared_ptr<Mesh>>& Model::Meshes() const
+{
+  return impl_->Meshes();
+}
+
+void Model::SetTextures(std::shared_ptr<TextureTable> textures)
+{
+  impl_->SetTextures(std::move(textures));
+}
+
+std::shared_ptr<TextureTable> Model::Textures() const
+{
+  return impl_->Textures();
+}
+}
+}
@@ -0,0 +1,38 @@
+#ifndef TWOPI_GEOMETRY_MODEL_H_
+#define TWOPI_GEOMETRY_MODEL_H_
+
+#include <memory>
+#include <vector>
+
+namespace twopi
+{
+namespace geometry
+{
+class Mesh;
+class TextureTable;
+
+class Model
+{
+public:
+  Model();
+  ~Model();
+
+  void AddMesh(std::shared_ptr<Mesh> mesh);
+  void SetMeshes(std::vector<std::shared_ptr<Mesh>>&& meshes);
+
+  int NumMeshes() const;
+  std::shared_ptr<Mesh> GetMesh(int index) const;
+  const std::vector<std::shared_ptr<Mesh>>& Meshes() const;
+
+  // Table resolving Mesh::TextureId, shared with other models of the same loader
+  void SetTextures(std::shared_ptr<TextureTable> textures);
+  std::shared_ptr<TextureTable> Textures() const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+}
+}
+
+#endif // TWOPI_GEOMETRY_MODEL_H_
@@ -0,0 +1,290 @@
+#include <twopi/geometry/tangent_generator.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include <twopi/core/thread_pool.h>
+#include <twopi/geometry/mesh.h>
+
+namespace twopi
+{
+namespace geometry
+{
+namespace
+{
+using Vector = std::array<float, 3>;
+
+// Loops over fewer triangles or vertices run on the calling thread
+constexpr size_t min_parallel_count = 16384;
+
+Vector Subtract(const Vector& a, const Vector& b)
+{
+  return { a[0] - b[0], a[1] - b[1], a[2] - b[2] };
+}
+
+float Dot(const Vector& a, const Vector& b)
+{
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+Vector Cross(const Vector& a, const Vector& b)
+{
+  return { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+}
+
+Vector Normalize(const Vector& v)
+{
+  const auto length = std::sqrt(Dot(v, v));
+  if (length == 0.f)
+    return v;
+  return { v[0] / length, v[1] / length, v[2] / length };
+}
+
+float Angle(const Vector& a, const Vector& b)
+{
+  const auto denominator = std::sqrt(Dot(a, a) * Dot(b, b));
+  if (denominator == 0.f)
+    return 0.f;
+  return std::acos(std::clamp(Dot(a, b) / denominator, -1.f, 1.f));
+}
+
+// Corners (3 * triangle + corner) around each vertex
+struct VertexCorners
+{
+  std::vector<uint32_t> offsets;
+  std::vector<uint32_t> corners;
+};
+
+VertexCorners BuildVertexCorners(const std::vector<uint32_t>& indices, size_t num_vertices)
+{
+  VertexCorners result;
+  result.offsets.assign(num_vertices + 1, 0);
+  for (auto index : indices)
+    result.offsets[index + 1]++;
+  for (size_t i = 0; i < num_vertices; i++)
+    result.offsets[i + 1] += result.offsets[i];
+
+  result.corners.resize(indices.size());
+  std::vector<uint32_t> cursor(result.offsets.begin(), result.offsets.end() - 1);
+  for (size_t i = 0; i < indices.size(); i++)
+    result.corners[cursor[indices[i]]++] = static_cast<uint32_t>(i);
+  return result;
+}
+}
+
+class TangentGenerator::Impl
+{
+public:
+  Impl()
+  {
+  }
+
+  explicit Impl(core::ThreadPool& thread_pool)
+    : thread_pool_(thread_pool)
+  {
+  }
+
+  ~Impl() = default;
+
+  void GenerateNormals(Mesh& mesh) const
+  {
+    const auto& indices = mesh.Indices();
+    const auto num_vertices = static_cast<size_t>(mesh.NumVertices());
+    const auto num_triangles = indices.size() / 3;
+    const auto positions = mesh.PositionView();
+    if (mesh.IsCompressed() || !positions || num_triangles == 0)
+      return;
+
+    const auto position = [&positions](uint32_t vertex) {
+      const auto* p = positions[vertex];
+      return Vector{ p[0], p[1], p[2] };
+    };
+
+    // Unnormalized face normals carry twice the triangle area
+    std::vector<Vector> face_normals(num_triangles);
+    ParallelFor(num_triangles, [&](size_t begin, size_t end) {
+      for (size_t t = begin; t < end; t++)
+      {
+        const auto p0 = position(indices[t * 3 + 0]);
+        face_normals[t] = Cross(Subtract(position(indices[t * 3 + 1]), p0), Subtract(position(indices[t * 3 + 2]), p0));
+      }
+      });
+
+    const auto vertex_corners = BuildVertexCorners(indices, num_vertices);
+
+    std::vector<float> normals(num_vertices * 3);
+    ParallelFor(num_vertices, [&](size_t begin, size_t end) {
+      for (size_t v = begin; v < end; v++)
+      {
+        Vector normal{ 0.f, 0.f, 0.f };
+        for (auto k = vertex_corners.offsets[v]; k < vertex_corners.offsets[v + 1]; k++)
+        {
+          const auto& face_normal = face_normals[vertex_corners.corners[k] / 3];
+          for (int j = 0; j < 3; j++)
+            normal[j] += face_normal[j];
+        }
+
+        normal = Normalize(normal);
+        std::copy(normal.begin(), normal.end(), normals.data() + v * 3);
+      }
+      });
+
+    if (mesh.IsInterleaved())
+    {
+      auto interleaved_vertices = mesh.InterleavedVertices();
+      for (size_t v = 0; v < num_vertices; v++)
+        std::copy_n(normals.data() + v * 3, 3, interleaved_vertices.data() + v * Mesh::interleaved_stride + 3);
+      mesh.SetInterleavedVertices(std::move(interleaved_vertices));
+    }
+    else
+      mesh.SetNormals(std::move(normals));
+  }
+
+  void GenerateTangents(Mesh& mesh) const
+  {
+    const auto& indices = mesh.Indices();
+    const auto num_vertices = static_cast<size_t>(mesh.NumVertices());
+    const auto num_triangles = indices.size() / 3;
+    const auto positions = mesh.PositionView();
+    const auto normals = mesh.NormalView();
+    const auto tex_coords = mesh.TexCoordView();
+    if (mesh.IsCompressed() || !positions || !normals || !tex_coords || num_triangles == 0)
+      return;
+
+    const auto position = [&positions](uint32_t vertex) {
+      const auto* p = positions[vertex];
+      return Vector{ p[0], p[1], p[2] };
+    };
+
+    const auto normal = [&normals](uint32_t vertex) {
+      const auto* n = normals[vertex];
+      return Vector{ n[0], n[1], n[2] };
+    };
+
+    // Face tangent and bitangent from the UV parametrization; zero for degenerate UVs
+    struct FaceFrame
+    {
+      Vector tangent;
+      Vector bitangent;
+    };
+
+    std::vector<FaceFrame> face_frames(num_triangles);
+    ParallelFor(num_triangles, [&](size_t begin, size_t end) {
+      for (size_t t = begin; t < end; t++)
+      {
+        const auto i0 = indices[t * 3 + 0];
+        const auto i1 = indices[t * 3 + 1];
+        const auto i2 = indices[t * 3 + 2];
+        const auto e1 = Subtract(position(i1), position(i0));
+        const auto e2 = Subtract(position(i2), position(i0));
+        const auto s1 = tex_coords[i1][0] - tex_coords[i0][0];
+        const auto t1 = tex_coords[i1][1] - tex_coords[i0][1];
+        const auto s2 = tex_coords[i2][0] - tex_coords[i0][0];
+        const auto t2 = tex_coords[i2][1] - tex_coords[i0][1];
+
+        auto& frame = face_frames[t];
+        const auto determinant = s1 * t2 - s2 * t1;
+        if (determinant == 0.f)
+        {
+          frame.tangent = { 0.f, 0.f, 0.f };
+          frame.bitangent = { 0.f, 0.f, 0.f };
+          continue;
+        }
+
+        const auto r = 1.f / determinant;
+        for (int j = 0; j < 3; j++)
+        {
+          frame.tangent[j] = (e1[j] * t2 - e2[j] * t1) * r;
+          frame.bitangent[j] = (e2[j] * s1 - e1[j] * s2) * r;
+        }
+      }
+      });
+
+    const auto vertex_corners = BuildVertexCorners(indices, num_vertices);
+
+    std::vector<float> tangents(num_vertices * 4);
+    ParallelFor(num_vertices, [&](size_t begin, size_t end) {
+      for (size_t v = begin; v < end; v++)
+      {
+        const auto n = normal(static_cast<uint32_t>(v));
+        Vector tangent{ 0.f, 0.f, 0.f };
+        Vector bitangent{ 0.f, 0.f, 0.f };
+
+        for (auto k = vertex_corners.offsets[v]; k < vertex_corners.offsets[v + 1]; k++)
+        {
+          const auto corner = vertex_corners.corners[k];
+          const auto t = corner / 3;
+          const auto c = corner % 3;
+
+          const auto p = position(indices[corner]);
+          const auto angle = Angle(
+            Subtract(position(indices[t * 3 + (c + 1) % 3]), p),
+            Subtract(position(indices[t * 3 + (c + 2) % 3]), p));
+
+          // Projected onto the tangent plane of the vertex normal
+          const auto& frame = face_frames[t];
+          const auto project = [&n](const Vector& x) {
+            const auto d = Dot(n, x);
+            return Normalize({ x[0] - n[0] * d, x[1] - n[1] * d, x[2] - n[2] * d });
+          };
+          const auto corner_tangent = project(frame.tangent);
+          const auto corner_bitangent = project(frame.bitangent);
+          for (int j = 0; j < 3; j++)
+          {
+            tangent[j] += corner_tangent[j] * angle;
+            bitangent[j] += corner_bitangent[j] * angle;
+          }
+        }
+
+        // Any tangent orthogonal to the normal when the UVs are degenerate everywhere around the vertex
+        tangent = Normalize(tangent);
+        if (Dot(tangent, tangent) == 0.f)
+          tangent = Normalize(std::abs(n[0]) < 0.9f ? Cross(n, { 1.f, 0.f, 0.f }) : Cross(n, { 0.f, 1.f, 0.f }));
+
+        auto* dst = tangents.data() + v * 4;
+        std::copy(tangent.begin(), tangent.end(), dst);
+        dst[3] = Dot(Cross(n, tangent), bitangent) < 0.f ? -1.f : 1.f;
+      }
+      });
+
+    mesh.SetTangents(std::move(tangents));
+  }
+
+private:
+  template <typename F>
+  void ParallelFor(size_t count, F&& f) const
+  {
+    if (count < min_parallel_count)
+      f(0, count);
+    else
+      thread_pool_->ParallelFor(count, std::forward<F>(f));
+  }
+
+  mutable core::LazyThreadPool thread_pool_;
+};
+
+TangentGenerator::TangentGenerator()
+{
+  impl_ = std::make_unique<Impl>();
+}
+
+TangentGenerator::TangentGenerator(core::ThreadPool& thread_pool)
+{
+  impl_ = std::make_unique<Impl>(thread_pool);
+}
+
+TangentGenerator::~TangentGenerator() = default;
+
+void TangentGenerator::GenerateNormals(Mesh& mesh) const
+{
+  impl_->GenerateNormals(mesh);
+}
+
+void TangentGenerator::GenerateTangents(Mesh& mesh) const
+{
+  impl_->GenerateTangents(mesh);
+}
+}
+}
@@ -0,0 +1,44 @@
+#ifndef TWOPI_GEOMETRY_TANGENT_GENERATOR_H_
+#define TWOPI_GEOMETRY_TANGENT_GENERATOR_H_
+
+#include <memory>
+
+namespace twopi
+{
+namespace core
+{
+class ThreadPool;
+}
+
+namespace geometry
+{
+class Mesh;
+
+// Smooth normals and tangent frames of float meshes, computed in parallel by gathering over the triangles
+// around each vertex. Vertices are smoothed where indices are shared, so meshes should be welded first.
+class TangentGenerator
+{
+public:
+  TangentGenerator();
+
+  // Gathers on thread_pool instead of a pool of its own
+  explicit TangentGenerator(core::ThreadPool& thread_pool);
+
+  ~TangentGenerator();
+
+  // Replaces normals with area weighted face normals
+  void GenerateNormals(Mesh& mesh) const;
+
+  // Sets Mesh::Tangents from normals and tex coords, following MikkTSpace: per-corner tangents projected
+  // onto the vertex normal plane and weighted by corner angle, with the bitangent sign in w.
+  // Vertices are not split at mirrored UVs, so such seams must already be separate vertices.
+  void GenerateTangents(Mesh& mesh) const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+}
+}
+
+#endif // TWOPI_GEOMETRY_TANGENT_GENERATOR_H_
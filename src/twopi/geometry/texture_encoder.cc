@@ -0,0 +1,637 @@
+#include <twopi/geometry/texture_encoder.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TWOPI_GEOMETRY_TEXTURE_ENCODER_SSE2
+#include <emmintrin.h>
+#endif
+
+#include <twopi/core/thread_pool.h>
+#include <twopi/geometry/image.h>
+
+namespace twopi
+{
+namespace geometry
+{
+namespace
+{
+using Color = std::array<float, 4>;
+
+// 4x4 RGBA pixels, one array of 16 values per channel
+struct Block
+{
+  alignas(16) float channels[4][16];
+
+  Color Pixel(int i) const { return { channels[0][i], channels[1][i], channels[2][i], channels[3][i] }; }
+};
+
+// Pixels of the block at column bx and row by from the top, clamped at the image edges
+Block FetchBlock(const Image<uint8_t>& image, int bx, int by)
+{
+  const auto width = image.Width();
+  const auto height = image.Height();
+  const auto comp = image.Comp();
+  const auto* data = image.Data();
+
+  Block block;
+  for (int y = 0; y < 4; y++)
+  {
+    // Image rows are stored from the bottom
+    const auto row = height - 1 - std::min(by * 4 + y, height - 1);
+    for (int x = 0; x < 4; x++)
+    {
+      const auto column = std::min(bx * 4 + x, width - 1);
+      const auto* src = data + (static_cast<size_t>(row) * width + column) * comp;
+      const auto i = y * 4 + x;
+
+      const uint8_t rgba[4] = {
+        src[0],
+        comp >= 3 ? src[1] : src[0],
+        comp >= 3 ? src[2] : src[0],
+        comp == 4 ? src[3] : comp == 2 ? src[1] : static_cast<uint8_t>(255) };
+      for (int c = 0; c < 4; c++)
+        block.channels[c][i] = rgba[c];
+    }
+  }
+  return block;
+}
+
+// Nearest palette entry of each pixel over channels [first_channel, first_channel + num_channels).
+// Returns the summed squared error.
+float SelectIndices(const Block& block, int first_channel, int num_channels, const Color* palette, int palette_size, uint8_t* indices)
+{
+  float total_error = 0.f;
+
+#ifdef TWOPI_GEOMETRY_TEXTURE_ENCODER_SSE2
+  for (int group = 0; group < 16; group += 4)
+  {
+    auto best_error = _mm_set1_ps(std::numeric_limits<float>::max());
+    auto best_index = _mm_setzero_si128();
+    for (int k = 0; k < palette_size; k++)
+    {
+      auto error = _mm_setzero_ps();
+      for (int c = first_channel; c < first_channel + num_channels; c++)
+      {
+        const auto difference = _mm_sub_ps(_mm_load_ps(block.channels[c] + group), _mm_set1_ps(palette[k][c]));
+        error = _mm_add_ps(error, _mm_mul_ps(difference, difference));
+      }
+
+      // Strictly less, so that ties keep the first entry as in the scalar loop
+      const auto less = _mm_castps_si128(_mm_cmplt_ps(error, best_error));
+      best_error = _mm_min_ps(error, best_error);
+      best_index = _mm_or_si128(_mm_and_si128(less, _mm_set1_epi32(k)), _mm_andnot_si128(less, best_index));
+    }
+
+    alignas(16) float errors[4];
+    alignas(16) int32_t group_indices[4];
+    _mm_store_ps(errors, best_error);
+    _mm_store_si128(reinterpret_cast<__m128i*>(group_indices), best_index);
+    for (int i = 0; i < 4; i++)
+    {
+      indices[group + i] = static_cast<uint8_t>(group_indices[i]);
+      total_error += errors[i];
+    }
+  }
+#else
+  for (int i = 0; i < 16; i++)
+  {
+    auto best_error = std::numeric_limits<float>::max();
+    int best_index = 0;
+    for (int k = 0; k < palette_size; k++)
+    {
+      float error = 0.f;
+      for (int c = first_channel; c < first_channel + num_channels; c++)
+      {
+        const auto difference = block.channels[c][i] - palette[k][c];
+        error += difference * difference;
+      }
+
+      if (error < best_error)
+      {
+        best_error = error;
+        best_index = k;
+      }
+    }
+
+    indices[i] = static_cast<uint8_t>(best_index);
+    total_error += best_error;
+  }
+#endif
+
+  return total_error;
+}
+
+// Extremes of the pixels, weighted by mask, along the principal axis of channels [0, num_channels)
+void PrincipalEndpoints(const Block& block, int num_channels, const bool* mask, Color& e0, Color& e1)
+{
+  Color mean{ 0.f, 0.f, 0.f, 0.f };
+  int count = 0;
+  for (int i = 0; i < 16; i++)
+  {
+    if (!mask[i])
+      continue;
+    for (int c = 0; c < num_channels; c++)
+      mean[c] += block.channels[c][i];
+    count++;
+  }
+  for (int c = 0; c < num_channels; c++)
+    mean[c] /= count;
+
+  float covariance[4][4] = {};
+  for (int i = 0; i < 16; i++)
+  {
+    if (!mask[i])
+      continue;
+    for (int a = 0; a < num_channels; a++)
+    {
+      for (int b = 0; b < num_channels; b++)
+        covariance[a][b] += (block.channels[a][i] - mean[a]) * (block.channels[b][i] - mean[b]);
+    }
+  }
+
+  // Power iteration from the bounding box diagonal
+  Color axis{ 0.f, 0.f, 0.f, 0.f };
+  for (int c = 0; c < num_channels; c++)
+  {
+    float low = 255.f;
+    float high = 0.f;
+    for (int i = 0; i < 16; i++)
+    {
+      if (mask[i])
+      {
+        low = std::min(low, block.channels[c][i]);
+        high = std::max(high, block.channels[c][i]);
+      }
+    }
+    axis[c] = high - low;
+  }
+
+  for (int iteration = 0; iteration < 8; iteration++)
+  {
+    Color next{ 0.f, 0.f, 0.f, 0.f };
+    float length = 0.f;
+    for (int a = 0; a < num_channels; a++)
+    {
+      for (int b = 0; b < num_channels; b++)
+        next[a] += covariance[a][b] * axis[b];
+      length = std::max(length, std::abs(next[a]));
+    }
+    if (length == 0.f)
+      break;
+    for (int c = 0; c < num_channels; c++)
+      axis[c] = next[c] / length;
+  }
+
+  float min_t = std::numeric_limits<float>::max();
+  float max_t = std::numeric_limits<float>::lowest();
+  for (int i = 0; i < 16; i++)
+  {
+    if (!mask[i])
+      continue;
+    float t = 0.f;
+    for (int c = 0; c < num_channels; c++)
+      t += (block.channels[c][i] - mean[c]) * axis[c];
+    min_t = std::min(min_t, t);
+    max_t = std::max(max_t, t);
+  }
+
+  float axis_length_squared = 0.f;
+  for (int c = 0; c < num_channels; c++)
+    axis_length_squared += axis[c] * axis[c];
+  if (axis_length_squared == 0.f)
+    min_t = max_t = axis_length_squared = 1.f;
+
+  e0 = mean;
+  e1 = mean;
+  for (int c = 0; c < num_channels; c++)
+  {
+    e0[c] = std::clamp(mean[c] + axis[c] * min_t / axis_length_squared, 0.f, 255.f);
+    e1[c] = std::clamp(mean[c] + axis[c] * max_t / axis_length_squared, 0.f, 255.f);
+  }
+}
+
+// Endpoints minimizing the squared error of pixels interpolated at weights[indices[i]] between them.
+// Returns false if the system is singular, e.g. when every pixel uses the same index.
+bool LeastSquaresEndpoints(const Block& block, int num_channels, const bool* mask, const uint8_t* indices, const float* weights, Color& e0, Color& e1)
+{
+  float aa = 0.f;
+  float ab = 0.f;
+  float bb = 0.f;
+  Color ax{ 0.f, 0.f, 0.f, 0.f };
+  Color bx{ 0.f, 0.f, 0.f, 0.f };
+  for (int i = 0; i < 16; i++)
+  {
+    if (!mask[i])
+      continue;
+    const auto t = weights[indices[i]];
+    const auto s = 1.f - t;
+    aa += s * s;
+    ab += s * t;
+    bb += t * t;
+    for (int c = 0; c < num_channels; c++)
+    {
+      ax[c] += s * block.channels[c][i];
+      bx[c] += t * block.channels[c][i];
+    }
+  }
+
+  const auto determinant = aa * bb - ab * ab;
+  if (std::abs(determinant) < 1e-6f)
+    return false;
+
+  for (int c = 0; c < num_channels; c++)
+  {
+    e0[c] = std::clamp((ax[c] * bb - bx[c] * ab) / determinant, 0.f, 255.f);
+    e1[c] = std::clamp((bx[c] * aa - ax[c] * ab) / determinant, 0.f, 255.f);
+  }
+  return true;
+}
+
+void Write16(uint8_t* dst, uint16_t value)
+{
+  dst[0] = static_cast<uint8_t>(value);
+  dst[1] = static_cast<uint8_t>(value >> 8);
+}
+
+// BC1 color endpoints in 5:6:5
+uint16_t Pack565(const Color& color)
+{
+  const auto r = static_cast<uint16_t>(std::lround(color[0] * 31.f / 255.f));
+  const auto g = static_cast<uint16_t>(std::lround(color[1] * 63.f / 255.f));
+  const auto b = static_cast<uint16_t>(std::lround(color[2] * 31.f / 255.f));
+  return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+Color Unpack565(uint16_t value)
+{
+  const auto r = (value >> 11) & 31;
+  const auto g = (value >> 5) & 63;
+  const auto b = value & 31;
+  return {
+    static_cast<float>((r << 3) | (r >> 2)),
+    static_cast<float>((g << 2) | (g >> 4)),
+    static_cast<float>((b << 3) | (b >> 2)),
+    255.f };
+}
+
+// Decoded palette of 565 endpoints; the 3-color mode (c0 <= c1) ends with transparent black
+int ColorPalette(uint16_t c0, uint16_t c1, Color* palette)
+{
+  palette[0] = Unpack565(c0);
+  palette[1] = Unpack565(c1);
+  if (c0 > c1)
+  {
+    for (int c = 0; c < 3; c++)
+    {
+      palette[2][c] = (2.f * palette[0][c] + palette[1][c]) / 3.f;
+      palette[3][c] = (palette[0][c] + 2.f * palette[1][c]) / 3.f;
+    }
+    return 4;
+  }
+
+  for (int c = 0; c < 3; c++)
+    palette[2][c] = (palette[0][c] + palette[1][c]) / 2.f;
+  palette[3] = { 0.f, 0.f, 0.f, 0.f };
+  return 3;
+}
+
+// 8 bytes of BC1 color. With transparency, pixels of alpha below 128 use the 3-color mode's transparent index.
+void EncodeColor(const Block& block, bool allow_transparent, uint8_t* dst)
+{
+  bool mask[16];
+  bool transparent = false;
+  bool any_opaque = false;
+  for (int i = 0; i < 16; i++)
+  {
+    mask[i] = !allow_transparent || block.channels[3][i] >= 128.f;
+    transparent |= !mask[i];
+    any_opaque |= mask[i];
+  }
+
+  if (!any_opaque)
+  {
+    Write16(dst + 0, 0);
+    Write16(dst + 2, 0);
+    std::fill(dst + 4, dst + 8, static_cast<uint8_t>(0xff));
+    return;
+  }
+
+  Color e0;
+  Color e1;
+  PrincipalEndpoints(block, 3, mask, e0, e1);
+
+  // Endpoint order selects the mode
+  const auto order = [transparent](uint16_t& c0, uint16_t& c1) {
+    if (transparent ? c0 > c1 : c0 < c1)
+      std::swap(c0, c1);
+  };
+
+  uint16_t c0 = Pack565(e0);
+  uint16_t c1 = Pack565(e1);
+  order(c0, c1);
+
+  Color palette[4];
+  uint8_t indices[16];
+  auto palette_size = ColorPalette(c0, c1, palette);
+  auto error = SelectIndices(block, 0, 3, palette, transparent ? 3 : palette_size, indices);
+
+  if (!transparent && c0 != c1)
+  {
+    // Palette entries 0, 1, 2, 3 lie at 0, 1, 1/3, 2/3 between the endpoints
+    constexpr float weights[4] = { 0.f, 1.f, 1.f / 3.f, 2.f / 3.f };
+    if (LeastSquaresEndpoints(block, 3, mask, indices, weights, e0, e1))
+    {
+      uint16_t refined_c0 = Pack565(e0);
+      uint16_t refined_c1 = Pack565(e1);
+      order(refined_c0, refined_c1);
+
+      Color refined_palette[4];
+      uint8_t refined_indices[16];
+      const auto refined_palette_size = ColorPalette(refined_c0, refined_c1, refined_palette);
+      const auto refined_error = SelectIndices(block, 0, 3, refined_palette, refined_palette_size, refined_indices);
+      if (refined_error < error)
+      {
+        c0 = refined_c0;
+        c1 = refined_c1;
+        std::copy_n(refined_indices, 16, indices);
+      }
+    }
+  }
+
+  uint32_t bits = 0;
+  for (int i = 0; i < 16; i++)
+  {
+    const uint32_t index = mask[i] ? indices[i] : 3;
+    bits |= index << (i * 2);
+  }
+
+  Write16(dst + 0, c0);
+  Write16(dst + 2, c1);
+  for (int i = 0; i < 4; i++)
+    dst[4 + i] = static_cast<uint8_t>(bits >> (i * 8));
+}
+
+// 8 bytes of BC4 for one channel, in the 8-value mode between the channel's extremes
+void EncodeChannel(const Block& block, int channel, uint8_t* dst)
+{
+  const auto* values = block.channels[channel];
+  const auto e0 = static_cast<uint8_t>(*std::max_element(values, values + 16));
+  const auto e1 = static_cast<uint8_t>(*std::min_element(values, values + 16));
+
+  uint8_t indices[16] = {};
+  if (e0 > e1)
+  {
+    Color palette[8] = {};
+    palette[0][channel] = e0;
+    palette[1][channel] = e1;
+    for (int k = 1; k < 7; k++)
+      palette[k + 1][channel] = ((7 - k) * e0 + k * e1) / 7.f;
+    SelectIndices(block, channel, 1, palette, 8, indices);
+  }
+
+  uint64_t bits = 0;
+  for (int i = 0; i < 16; i++)
+    bits |= static_cast<uint64_t>(indices[i]) << (i * 3);
+
+  dst[0] = e0;
+  dst[1] = e1;
+  for (int i = 0; i < 6; i++)
+    dst[2 + i] = static_cast<uint8_t>(bits >> (i * 8));
+}
+
+constexpr int bc7_weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// BC7 mode 6 endpoints: 7 bits per channel and a shared low bit per endpoint
+struct Bc7Endpoints
+{
+  std::array<int, 4> q0;
+  std::array<int, 4> q1;
+  int p0;
+  int p1;
+};
+
+float Bc7SelectIndices(const Block& block, const Bc7Endpoints& endpoints, uint8_t* indices)
+{
+  Color palette[16];
+  for (int k = 0; k < 16; k++)
+  {
+    for (int c = 0; c < 4; c++)
+    {
+      const auto v0 = (endpoints.q0[c] << 1) | endpoints.p0;
+      const auto v1 = (endpoints.q1[c] << 1) | endpoints.p1;
+      palette[k][c] = static_cast<float>(((64 - bc7_weights[k]) * v0 + bc7_weights[k] * v1 + 32) >> 6);
+    }
+  }
+  return SelectIndices(block, 0, 4, palette, 16, indices);
+}
+
+// Best quantization of the endpoints over the four shared bit combinations
+float Bc7Quantize(const Block& block, const Color& e0, const Color& e1, Bc7Endpoints& endpoints, uint8_t* indices)
+{
+  auto best_error = std::numeric_limits<float>::max();
+  for (int p = 0; p < 4; p++)
+  {
+    Bc7Endpoints candidate;
+    candidate.p0 = p & 1;
+    candidate.p1 = p >> 1;
+    for (int c = 0; c < 4; c++)
+    {
+      candidate.q0[c] = std::clamp(static_cast<int>(std::lround((e0[c] - candidate.p0) / 2.f)), 0, 127);
+      candidate.q1[c] = std::clamp(static_cast<int>(std::lround((e1[c] - candidate.p1) / 2.f)), 0, 127);
+    }
+
+    uint8_t candidate_indices[16];
+    const auto error = Bc7SelectIndices(block, candidate, candidate_indices);
+    if (error < best_error)
+    {
+      best_error = error;
+      endpoints = candidate;
+      std::copy_n(candidate_indices, 16, indices);
+    }
+  }
+  return best_error;
+}
+
+// Little-endian bit stream of one 128-bit block
+class BitWriter
+{
+public:
+  explicit BitWriter(uint8_t* dst)
+    : dst_(dst)
+  {
+    std::fill(dst_, dst_ + 16, static_cast<uint8_t>(0));
+  }
+
+  void Write(uint32_t value, int num_bits)
+  {
+    for (int i = 0; i < num_bits; i++, position_++)
+    {
+      if (value & (1u << i))
+        dst_[position_ / 8] |= static_cast<uint8_t>(1u << (position_ % 8));
+    }
+  }
+
+private:
+  uint8_t* dst_;
+  int position_ = 0;
+};
+
+void EncodeBc7(const Block& block, uint8_t* dst)
+{
+  bool mask[16];
+  std::fill(mask, mask + 16, true);
+
+  Color e0;
+  Color e1;
+  PrincipalEndpoints(block, 4, mask, e0, e1);
+
+  Bc7Endpoints endpoints;
+  uint8_t indices[16];
+  auto error = Bc7Quantize(block, e0, e1, endpoints, indices);
+
+  float weights[16];
+  for (int k = 0; k < 16; k++)
+    weights[k] = bc7_weights[k] / 64.f;
+  if (LeastSquaresEndpoints(block, 4, mask, indices, weights, e0, e1))
+  {
+    Bc7Endpoints refined_endpoints;
+    uint8_t refined_indices[16];
+    if (Bc7Quantize(block, e0, e1, refined_endpoints, refined_indices) < error)
+    {
+      endpoints = refined_endpoints;
+      std::copy_n(refined_indices, 16, indices);
+    }
+  }
+
+  // The anchor pixel's index is stored without its high bit, so it must be below 8
+  if (indices[0] >= 8)
+  {
+    std::swap(endpoints.q0, endpoints.q1);
+    std::swap(endpoints.p0, endpoints.p1);
+    for (auto& index : indices)
+      index = static_cast<uint8_t>(15 - index);
+  }
+
+  BitWriter writer(dst);
+  writer.Write(1u << 6, 7);
+  for (int c = 0; c < 4; c++)
+  {
+    writer.Write(endpoints.q0[c], 7);
+    writer.Write(endpoints.q1[c], 7);
+  }
+  writer.Write(endpoints.p0, 1);
+  writer.Write(endpoints.p1, 1);
+  writer.Write(indices[0], 3);
+  for (int i = 1; i < 16; i++)
+    writer.Write(indices[i], 4);
+}
+
+void EncodeBlock(const Block& block, BlockFormat format, uint8_t* dst)
+{
+  switch (format)
+  {
+  case BlockFormat::BC1:
+    EncodeColor(block, true, dst);
+    break;
+
+  case BlockFormat::BC3:
+    EncodeChannel(block, 3, dst);
+    EncodeColor(block, false, dst + 8);
+    break;
+
+  case BlockFormat::BC5:
+    EncodeChannel(block, 0, dst);
+    EncodeChannel(block, 1, dst + 8);
+    break;
+
+  case BlockFormat::BC7:
+    EncodeBc7(block, dst);
+    break;
+  }
+}
+}
+
+class TextureEncoder::Impl
+{
+public:
+  Impl()
+  {
+  }
+
+  explicit Impl(core::ThreadPool& thread_pool)
+    : thread_pool_(thread_pool)
+  {
+  }
+
+  ~Impl() = default;
+
+  std::shared_ptr<CompressedImage> Encode(const Image<uint8_t>& image, BlockFormat format) const
+  {
+    auto compressed_image = std::make_shared<CompressedImage>(image.Width(), image.Height(), format);
+    compressed_image->AddLevel(EncodeBlocks(image, format));
+    return compressed_image;
+  }
+
+  std::shared_ptr<CompressedImage> Encode(const std::vector<std::shared_ptr<Image<uint8_t>>>& levels, BlockFormat format) const
+  {
+    auto compressed_image = std::make_shared<CompressedImage>(levels[0]->Width(), levels[0]->Height(), format);
+    for (const auto& level : levels)
+      compressed_image->AddLevel(EncodeBlocks(*level, format));
+    return compressed_image;
+  }
+
+  std::vector<uint8_t> EncodeBlocks(const Image<uint8_t>& image, BlockFormat format) const
+  {
+    const auto blocks_x = (image.Width() + 3) / 4;
+    const auto blocks_y = (image.Height() + 3) / 4;
+    const auto block_size = BlockSize(format);
+
+    std::vector<uint8_t> blocks(static_cast<size_t>(blocks_x) * blocks_y * block_size);
+    thread_pool_->ParallelFor(blocks_y, [&](size_t begin, size_t end) {
+      for (auto by = begin; by < end; by++)
+      {
+        auto* dst = blocks.data() + by * blocks_x * block_size;
+        for (int bx = 0; bx < blocks_x; bx++, dst += block_size)
+          EncodeBlock(FetchBlock(image, bx, static_cast<int>(by)), format, dst);
+      }
+      });
+
+    return blocks;
+  }
+
+private:
+  mutable core::LazyThreadPool thread_pool_;
+};
+
+TextureEncoder::TextureEncoder()
+{
+  impl_ = std::make_unique<Impl>();
+}
+
+TextureEncoder::TextureEncoder(core::ThreadPool& thread_pool)
+{
+  impl_ = std::make_unique<Impl>(thread_pool);
+}
+
+TextureEncoder::~TextureEncoder() = default;
+
+std::shared_ptr<CompressedImage> TextureEncoder::Encode(const Image<uint8_t>& image, BlockFormat format) const
+{
+  return impl_->Encode(image, format);
+}
+
+std::shared_ptr<CompressedImage> TextureEncoder::Encode(const std::vector<std::shared_ptr<Image<uint8_t>>>& levels, BlockFormat format) const
+{
+  return impl_->Encode(levels, format);
+}
+
+std::vector<uint8_t> TextureEncoder::EncodeBlocks(const Image<uint8_t>& image, BlockFormat format) const
+{
+  return impl_->EncodeBlocks(image, format);
+}
+}
+}
@@ -0,0 +1,51 @@
+#ifndef TWOPI_GEOMETRY_TEXTURE_ENCODER_H_
+#define TWOPI_GEOMETRY_TEXTURE_ENCODER_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <twopi/geometry/compressed_image.h>
+
+namespace twopi
+{
+namespace core
+{
+class ThreadPool;
+}
+
+namespace geometry
+{
+template <typename T>
+class Image;
+
+// CPU block compression of 8-bit images, encoding rows of blocks in parallel.
+// Endpoints follow the principal axis of each block, refined once by least squares; BC7 uses mode 6 only.
+class TextureEncoder
+{
+public:
+  TextureEncoder();
+
+  // Encodes block rows on thread_pool instead of a pool of its own
+  explicit TextureEncoder(core::ThreadPool& thread_pool);
+
+  ~TextureEncoder();
+
+  // Image with the encoded pixels as its only level. Images with fewer than 4 components are
+  // expanded as gray, gray and alpha, or RGB, with opaque alpha.
+  std::shared_ptr<CompressedImage> Encode(const Image<uint8_t>& image, BlockFormat format) const;
+
+  // Image with every level of a mip chain, e.g. from MipmapGenerator, ready to cache with SaveDds
+  std::shared_ptr<CompressedImage> Encode(const std::vector<std::shared_ptr<Image<uint8_t>>>& levels, BlockFormat format) const;
+
+  // Blocks of a whole image in CompressedImage order, e.g. for CompressedImage::AddLevel
+  std::vector<uint8_t> EncodeBlocks(const Image<uint8_t>& image, BlockFormat format) const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+}
+}
+
+#endif // TWOPI_GEOMETRY_TEXTURE_ENCODER_H_
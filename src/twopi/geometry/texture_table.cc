@@ -0,0 +1,76 @@
+#include <twopi/geometry/texture_table.h>
+
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace twopi
+{
+namespace geometry
+{
+class TextureTable::Impl
+{
+public:
+  Impl()
+  {
+  }
+
+  ~Impl() = default;
+
+  uint32_t Intern(const std::string& filepath)
+  {
+    const auto normalized_filepath = std::filesystem::path(filepath).lexically_normal().generic_string();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = ids_.find(normalized_filepath);
+    if (it != ids_.end())
+      return it->second;
+
+    const auto id = static_cast<uint32_t>(filepaths_.size());
+    filepaths_.push_back(normalized_filepath);
+    ids_.emplace(normalized_filepath, id);
+    return id;
+  }
+
+  std::string Filepath(uint32_t id) const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return filepaths_[id];
+  }
+
+  int NumTextures() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<int>(filepaths_.size());
+  }
+
+private:
+  std::vector<std::string> filepaths_;
+  std::unordered_map<std::string, uint32_t> ids_;
+  mutable std::mutex mutex_;
+};
+
+TextureTable::TextureTable()
+{
+  impl_ = std::make_unique<Impl>();
+}
+
+TextureTable::~TextureTable() = default;
+
+uint32_t TextureTable::Intern(const std::string& filepath)
+{
+  return impl_->Intern(filepath);
+}
+
+std::string TextureTable::Filepath(uint32_t id) const
+{
+  return impl_->Filepath(id);
+}
+
+int TextureTable::NumTextures() const
+{
+  return impl_->NumTextures();
+}
+}
+}
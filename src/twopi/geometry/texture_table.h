@@ -0,0 +1,36 @@
+#ifndef TWOPI_GEOMETRY_TEXTURE_TABLE_H_
+#define TWOPI_GEOMETRY_TEXTURE_TABLE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace twopi
+{
+namespace geometry
+{
+// Interned texture filepaths. Meshes refer to textures by id, so a texture shared by many meshes
+// and models of the same loader is decoded and uploaded once. Thread safe.
+class TextureTable
+{
+public:
+  static constexpr uint32_t invalid_id = ~0u;
+
+public:
+  TextureTable();
+  ~TextureTable();
+
+  // Id of the lexically normalized filepath, added if not present
+  uint32_t Intern(const std::string& filepath);
+
+  std::string Filepath(uint32_t id) const;
+  int NumTextures() const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+}
+}
+
+#endif // TWOPI_GEOMETRY_TEXTURE_TABLE_H_
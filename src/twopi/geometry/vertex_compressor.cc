@@ -0,0 +1,131 @@
+#include <twopi/geometry/vertex_compressor.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <twopi/core/half.h>
+#include <twopi/geometry/mesh.h>
+
+namespace twopi
+{
+namespace geometry
+{
+namespace
+{
+int16_t ToSnorm16(float value)
+{
+  value = std::clamp(value, -1.f, 1.f);
+  return static_cast<int16_t>(std::lround(value * 32767.f));
+}
+
+float FromSnorm16(int16_t value)
+{
+  return std::max(static_cast<float>(value) / 32767.f, -1.f);
+}
+}
+
+VertexCompressor::VertexCompressor() = default;
+
+VertexCompressor::~VertexCompressor() = default;
+
+void VertexCompressor::Compress(Mesh& mesh) const
+{
+  const auto positions = mesh.PositionView();
+  if (!positions)
+    return;
+
+  const auto normals = mesh.NormalView();
+  const auto tex_coords = mesh.TexCoordView();
+  const auto num_vertices = mesh.NumVertices();
+
+  // Bounding box for position quantization
+  std::array<float, 3> box_min;
+  std::array<float, 3> box_max;
+  box_min.fill(std::numeric_limits<float>::max());
+  box_max.fill(std::numeric_limits<float>::lowest());
+  for (int i = 0; i < num_vertices; i++)
+  {
+    for (int j = 0; j < 3; j++)
+    {
+      box_min[j] = std::min(box_min[j], positions[i][j]);
+      box_max[j] = std::max(box_max[j], positions[i][j]);
+    }
+  }
+
+  std::array<float, 3> scale;
+  std::array<float, 3> inverse_scale;
+  for (int j = 0; j < 3; j++)
+  {
+    scale[j] = box_max[j] > box_min[j] ? box_max[j] - box_min[j] : 1.f;
+    inverse_scale[j] = 65535.f / scale[j];
+  }
+
+  constexpr float default_normal[3] = { 0.f, 0.f, 1.f };
+
+  std::vector<uint16_t> compressed_vertices(static_cast<size_t>(num_vertices) * Mesh::compressed_stride);
+  for (int i = 0; i < num_vertices; i++)
+  {
+    auto* vertex = compressed_vertices.data() + static_cast<size_t>(i) * Mesh::compressed_stride;
+
+    for (int j = 0; j < 3; j++)
+    {
+      const auto quantized = std::lround((positions[i][j] - box_min[j]) * inverse_scale[j]);
+      vertex[j] = static_cast<uint16_t>(std::clamp(quantized, 0l, 65535l));
+    }
+    vertex[3] = 0;
+
+    const auto normal = OctahedralEncode(normals ? normals[i] : default_normal);
+    vertex[4] = static_cast<uint16_t>(normal[0]);
+    vertex[5] = static_cast<uint16_t>(normal[1]);
+
+    vertex[6] = tex_coords ? core::FloatToHalf(tex_coords[i][0]) : 0;
+    vertex[7] = tex_coords ? core::FloatToHalf(tex_coords[i][1]) : 0;
+  }
+
+  mesh.SetPositionDequantization(box_min, scale);
+  mesh.SetCompressedVertices(std::move(compressed_vertices));
+  mesh.SetVertices({});
+  mesh.SetNormals({});
+  mesh.SetTexCoords({});
+  mesh.SetInterleavedVertices({});
+}
+
+std::array<int16_t, 2> VertexCompressor::OctahedralEncode(const float* normal)
+{
+  const auto l1 = std::abs(normal[0]) + std::abs(normal[1]) + std::abs(normal[2]);
+  if (l1 == 0.f)
+    return { 0, 0 };
+
+  auto x = normal[0] / l1;
+  auto y = normal[1] / l1;
+
+  // Fold the lower hemisphere over the diagonals
+  if (normal[2] < 0.f)
+  {
+    const auto folded_x = (1.f - std::abs(y)) * (x >= 0.f ? 1.f : -1.f);
+    const auto folded_y = (1.f - std::abs(x)) * (y >= 0.f ? 1.f : -1.f);
+    x = folded_x;
+    y = folded_y;
+  }
+
+  return { ToSnorm16(x), ToSnorm16(y) };
+}
+
+std::array<float, 3> VertexCompressor::OctahedralDecode(const std::array<int16_t, 2>& encoded)
+{
+  std::array<float, 3> n{ FromSnorm16(encoded[0]), FromSnorm16(encoded[1]), 0.f };
+  n[2] = 1.f - std::abs(n[0]) - std::abs(n[1]);
+
+  const auto t = std::max(-n[2], 0.f);
+  n[0] += n[0] >= 0.f ? -t : t;
+  n[1] += n[1] >= 0.f ? -t : t;
+
+  const auto length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+  for (auto& v : n)
+    v /= length;
+  return n;
+}
+}
+}
@@ -0,0 +1,32 @@
+#ifndef TWOPI_GEOMETRY_VERTEX_COMPRESSOR_H_
+#define TWOPI_GEOMETRY_VERTEX_COMPRESSOR_H_
+
+#include <array>
+#include <cstdint>
+
+namespace twopi
+{
+namespace geometry
+{
+class Mesh;
+
+// Converts float vertex attributes to Mesh's compressed layout:
+// 16-bit positions quantized to the mesh bounding box, octahedral 2x16-bit normals and half float tex coords.
+class VertexCompressor
+{
+public:
+  VertexCompressor();
+  ~VertexCompressor();
+
+  // Replaces the float attributes of mesh with compressed vertices
+  void Compress(Mesh& mesh) const;
+
+  static std::array<int16_t, 2> OctahedralEncode(const float* normal);
+  static std::array<float, 3> OctahedralDecode(const std::array<int16_t, 2>& encoded);
+
+private:
+};
+}
+}
+
+#endif // TWOPI_GEOMETRY_VERTEX_COMPRESSOR_H_
@@ -1,6 +1,10 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
+// Compressed vertices: position is R16G16B16A16_UNORM with dequantization folded into model matrix,
+// normal is octahedral R16G16_SNORM, tex_coord is R16G16_SFLOAT
+layout (constant_id = 0) const bool compressed_vertex = false;
+
 // Vertex
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec3 normal;
@@ -18,6 +22,14 @@ layout (std140, binding = 1) uniform ModelUbo
   mat3 model_inverse_transpose;
 } model;
 
+vec3 OctahedralDecode(vec2 e)
+{
+  vec3 n = vec3(e, 1.f - abs(e.x) - abs(e.y));
+  float t = max(-n.z, 0.f);
+  n.xy += vec2(n.x >= 0.f ? -t : t, n.y >= 0.f ? -t : t);
+  return normalize(n);
+}
+
 layout (location = 0) out vec3 frag_position;
 layout (location = 1) out vec3 frag_normal;
 
@@ -26,5 +38,5 @@ void main()
   vec4 p = model.model * vec4(position, 1.f);
   gl_Position = camera.projection * camera.view * p;
   frag_position = p.xyz / p.w;
-  frag_normal = model.model_inverse_transpose * normal;
+  frag_normal = model.model_inverse_transpose * (compressed_vertex ? OctahedralDecode(normal.xy) : normal);
 }
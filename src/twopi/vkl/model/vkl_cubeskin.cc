@@ -89,6 +89,11 @@ Cubeskin::Cubeskin(std::shared_ptr<vkl::Context> context, int segments, int dept
 
   num_support_indices_ = support_index_buffer.size();
 
+  // 16-bit indices when every vertex index stays below the restart value 0xFFFF
+  const auto num_vertices = segments * segments * depth;
+  index_type_ = num_vertices < 0xFFFF ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
+  const auto index_size = index_type_ == vk::IndexType::eUint16 ? sizeof(uint16_t) : sizeof(uint32_t);
+
   shell_buffer_size_ = vertex_buffer.size() * sizeof(float);
   shell_offset_ = shell_buffer_size_;
 
@@ -100,18 +105,25 @@ Cubeskin::Cubeskin(std::shared_ptr<vkl::Context> context, int segments, int dept
     .setUsage(vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eStorageBuffer)
     .setSize(shell_buffer_size_ * 2); // Double buffering
   shell_buffer_ = device.createBuffer(buffer_create_info);
-  shell_memory_ = context->AllocateDeviceMemory(shell_buffer_);
+  shell_memory_ = context->AllocateDeviceMemory(shell_buffer_, MemoryCategory::VERTEX);
   device.bindBufferMemory(shell_buffer_, shell_memory_.device_memory, shell_memory_.offset);
 
   buffer_create_info
     .setUsage(vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer)
-    .setSize(support_index_buffer.size() * sizeof(uint32_t));
+    .setSize(support_index_buffer.size() * index_size);
   index_buffer_ = device.createBuffer(buffer_create_info);
-  index_memory_ = context->AllocateDeviceMemory(index_buffer_);
+  index_memory_ = context->AllocateDeviceMemory(index_buffer_, MemoryCategory::INDEX);
   device.bindBufferMemory(index_buffer_, index_memory_.device_memory, index_memory_.offset);
 
   context->ToGpu(vertex_buffer, shell_buffer_, 0);
-  context->ToGpu(support_index_buffer, index_buffer_, 0);
+  if (index_type_ == vk::IndexType::eUint16)
+  {
+    // Narrowing maps the restart index -1 to 0xFFFF
+    std::vector<uint16_t> short_support_index_buffer(support_index_buffer.begin(), support_index_buffer.end());
+    context->ToGpu(short_support_index_buffer, index_buffer_, 0);
+  }
+  else
+    context->ToGpu(support_index_buffer, index_buffer_, 0);
 }
 
 Cubeskin::~Cubeskin()
@@ -120,6 +132,8 @@ Cubeskin::~Cubeskin()
 
   device.destroyBuffer(shell_buffer_);
   device.destroyBuffer(index_buffer_);
+  Context()->FreeMemory(shell_memory_);
+  Context()->FreeMemory(index_memory_);
 }
 
 void Cubeskin::Update(vk::CommandBuffer& command_buffer)
@@ -130,7 +144,7 @@ void Cubeskin::DrawSupports(vk::CommandBuffer& command_buffer)
 {
   command_buffer.bindVertexBuffers(0, { shell_buffer_ }, { 0 });
 
-  command_buffer.bindIndexBuffer(index_buffer_, support_index_offset_, vk::IndexType::eUint32);
+  command_buffer.bindIndexBuffer(index_buffer_, support_index_offset_, index_type_);
 
   command_buffer.drawIndexed(num_support_indices_, 1, 0, 0, 0);
 
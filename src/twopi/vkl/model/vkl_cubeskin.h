@@ -43,6 +43,7 @@ private:
   // Multiple index buffers
   vk::Buffer index_buffer_;
   Memory index_memory_;
+  vk::IndexType index_type_ = vk::IndexType::eUint32;
   vk::DeviceSize support_index_offset_ = 0;
   uint32_t num_support_indices_ = 0;
 };
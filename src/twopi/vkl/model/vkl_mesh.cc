@@ -0,0 +1,257 @@
+#include <twopi/vkl/model/vkl_mesh.h>
+
+#include <algorithm>
+
+#include <twopi/vkl/vkl_context.h>
+#include <twopi/vkl/vkl_vertex_buffer.h>
+
+namespace twopi
+{
+namespace vkl
+{
+Mesh::Mesh(std::shared_ptr<vkl::Context> context, const geometry::Mesh& mesh)
+  : Object(context)
+{
+  const auto num_vertices = mesh.NumVertices();
+  compressed_ = mesh.IsCompressed();
+  interleaved_ = !compressed_ && mesh.IsInterleaved();
+  meshlets_ = mesh.Meshlets();
+
+  // Full resolution followed by levels of detail
+  uint32_t num_indices = static_cast<uint32_t>(mesh.Indices().size());
+  lods_.push_back({ 0, num_indices, 0.f });
+  for (const auto& lod : mesh.Lods())
+  {
+    lods_.push_back({ num_indices, static_cast<uint32_t>(lod.indices.size()), lod.error });
+    num_indices += static_cast<uint32_t>(lod.indices.size());
+  }
+
+  if (compressed_)
+  {
+    position_offset_ = mesh.PositionOffset();
+    position_scale_ = mesh.PositionScale();
+  }
+
+  // Bounds are usually computed at load time
+  const auto bounds = mesh.Bounds().IsEmpty() ? mesh.ComputeBounds() : mesh.Bounds();
+  center_ = bounds.center;
+  radius_ = std::max(bounds.radius, 0.f);
+
+  // Vertex buffer
+  CreateVertexBuffer(num_vertices, num_indices, mesh.HasShortIndices());
+  if (compressed_)
+    context->ToGpu(mesh.CompressedVertices(), vertex_buffer_->Buffer(), 0);
+  else if (interleaved_)
+    context->ToGpu(mesh.InterleavedVertices(), vertex_buffer_->Buffer(), 0);
+  else
+  {
+    const auto positions = mesh.Positions();
+
+    // Meshes without normals are lit as facing +z
+    std::vector<float> normals(static_cast<size_t>(num_vertices) * 3, 0.f);
+    const auto normal_view = mesh.NormalView();
+    for (int i = 0; i < num_vertices; i++)
+    {
+      if (normal_view)
+        std::copy_n(normal_view[i], 3, normals.data() + i * 3);
+      else
+        normals[i * 3 + 2] = 1.f;
+    }
+
+    context->ToGpu(positions, vertex_buffer_->Buffer(), vertex_buffer_->Offset(0));
+    context->ToGpu(normals, vertex_buffer_->Buffer(), vertex_buffer_->Offset(1));
+  }
+
+  vertex_buffer_->UploadIndices(mesh.Indices());
+  for (size_t i = 0; i < mesh.Lods().size(); i++)
+    vertex_buffer_->UploadIndices(mesh.Lods()[i].indices, lods_[i + 1].first_index);
+}
+
+Mesh::Mesh(std::shared_ptr<vkl::Context> context, const geometry::MeshCache::View& view, int mesh_index)
+  : Object(context)
+{
+  using Section = geometry::MeshCache::Section;
+
+  const auto section_size = [&view, mesh_index](Section section) {
+    return view.Size(mesh_index, section);
+  };
+
+  compressed_ = section_size(Section::COMPRESSED_VERTICES) > 0;
+  interleaved_ = !compressed_ && section_size(Section::INTERLEAVED_VERTICES) > 0;
+
+  int num_vertices;
+  if (compressed_)
+    num_vertices = static_cast<int>(view.Count<uint16_t>(mesh_index, Section::COMPRESSED_VERTICES) / geometry::Mesh::compressed_stride);
+  else if (interleaved_)
+    num_vertices = static_cast<int>(view.Count<float>(mesh_index, Section::INTERLEAVED_VERTICES) / geometry::Mesh::interleaved_stride);
+  else
+    num_vertices = static_cast<int>(view.Count<float>(mesh_index, Section::VERTICES) / 3);
+
+  const auto* meshlets = view.Data<geometry::Meshlet>(mesh_index, Section::MESHLETS);
+  meshlets_.assign(meshlets, meshlets + view.Count<geometry::Meshlet>(mesh_index, Section::MESHLETS));
+
+  // Meshes with short indices store them in SHORT_INDICES instead of INDICES. LOD_INDICES stay 32-bit in the
+  // cache and are narrowed in the stage buffer.
+  const auto short_indices = section_size(Section::SHORT_INDICES) > 0;
+  uint32_t num_indices = static_cast<uint32_t>(short_indices
+    ? view.Count<uint16_t>(mesh_index, Section::SHORT_INDICES)
+    : view.Count<uint32_t>(mesh_index, Section::INDICES));
+  lods_.push_back({ 0, num_indices, 0.f });
+
+  const auto* lod_entries = view.Data<geometry::MeshCache::LodEntry>(mesh_index, Section::LOD_TABLE);
+  const auto num_lods = view.Count<geometry::MeshCache::LodEntry>(mesh_index, Section::LOD_TABLE);
+  for (uint64_t i = 0; i < num_lods; i++)
+  {
+    lods_.push_back({ num_indices, lod_entries[i].num_indices, lod_entries[i].error });
+    num_indices += lod_entries[i].num_indices;
+  }
+
+  if (compressed_ && view.Count<float>(mesh_index, Section::POSITION_DEQUANTIZATION) == 6)
+  {
+    const auto* dequantization = view.Data<float>(mesh_index, Section::POSITION_DEQUANTIZATION);
+    std::copy_n(dequantization, 3, position_offset_.begin());
+    std::copy_n(dequantization + 3, 3, position_scale_.begin());
+  }
+
+  // Map only accepts caches whose meshes all have bounds
+  const auto& bounds = *view.Data<geometry::MeshBounds>(mesh_index, Section::BOUNDS);
+  center_ = bounds.center;
+  radius_ = std::max(bounds.radius, 0.f);
+
+  // Vertex buffer. Sections are copied from the mapping into the stage buffer, in stage sized chunks if larger.
+  CreateVertexBuffer(num_vertices, num_indices, short_indices);
+  const auto upload = [&context, &view, mesh_index](Section section, vk::Buffer buffer, vk::DeviceSize offset) {
+    context->ToGpu(view.Data(mesh_index, section), view.Size(mesh_index, section), buffer, offset);
+  };
+
+  if (compressed_)
+    upload(Section::COMPRESSED_VERTICES, vertex_buffer_->Buffer(), 0);
+  else if (interleaved_)
+    upload(Section::INTERLEAVED_VERTICES, vertex_buffer_->Buffer(), 0);
+  else
+  {
+    upload(Section::VERTICES, vertex_buffer_->Buffer(), vertex_buffer_->Offset(0));
+
+    // Meshes without normals are lit as facing +z
+    if (section_size(Section::NORMALS) == vertex_buffer_->Size(1))
+      upload(Section::NORMALS, vertex_buffer_->Buffer(), vertex_buffer_->Offset(1));
+    else
+    {
+      context->ToGpu(vertex_buffer_->Size(1), vertex_buffer_->Buffer(), vertex_buffer_->Offset(1), [num_vertices](void* map) {
+        auto* normals = static_cast<float*>(map);
+        for (int i = 0; i < num_vertices; i++)
+        {
+          normals[i * 3 + 0] = 0.f;
+          normals[i * 3 + 1] = 0.f;
+          normals[i * 3 + 2] = 1.f;
+        }
+        });
+    }
+  }
+
+  if (short_indices)
+    vertex_buffer_->UploadIndices(view.Data<uint16_t>(mesh_index, Section::SHORT_INDICES), lods_[0].num_indices);
+  else
+    vertex_buffer_->UploadIndices(view.Data<uint32_t>(mesh_index, Section::INDICES), lods_[0].num_indices);
+
+  const auto* lod_indices = view.Data<uint32_t>(mesh_index, Section::LOD_INDICES);
+  for (size_t i = 1; i < lods_.size(); i++)
+  {
+    vertex_buffer_->UploadIndices(lod_indices, lods_[i].num_indices, lods_[i].first_index);
+    lod_indices += lods_[i].num_indices;
+  }
+}
+
+Mesh::~Mesh() = default;
+
+void Mesh::CreateVertexBuffer(int num_vertices, uint32_t num_indices, bool short_indices)
+{
+  vertex_buffer_ = std::make_unique<VertexBuffer>(Context(), num_vertices, static_cast<int>(num_indices), short_indices);
+  if (compressed_)
+  {
+    (*vertex_buffer_)
+      .SetInterleaved()
+      .AddAttribute<uint16_t, 4>(0)
+      .AddAttribute<uint16_t, 2>(1)
+      .AddAttribute<uint16_t, 2>(2)
+      .Prepare();
+  }
+  else if (interleaved_)
+  {
+    (*vertex_buffer_)
+      .SetInterleaved()
+      .AddAttribute<float, 3>(0)
+      .AddAttribute<float, 3>(1)
+      .AddAttribute<float, 2>(2)
+      .Prepare();
+  }
+  else
+  {
+    (*vertex_buffer_)
+      .AddAttribute<float, 3>(0)
+      .AddAttribute<float, 3>(1)
+      .Prepare();
+  }
+}
+
+vk::DeviceSize Mesh::BufferSize() const
+{
+  return vertex_buffer_->BufferSize();
+}
+
+int Mesh::SelectLod(float max_error) const
+{
+  int level = 0;
+  while (level + 1 < lods_.size() && lods_[level + 1].error <= max_error)
+    level++;
+  return level;
+}
+
+void Mesh::Draw(vk::CommandBuffer& command_buffer, int lod)
+{
+  Bind(command_buffer);
+
+  const auto& level = lods_[lod];
+  command_buffer.drawIndexed(level.num_indices, 1, level.first_index, 0, 0);
+}
+
+void Mesh::DrawMeshlets(vk::CommandBuffer& command_buffer, const std::vector<uint32_t>& meshlets)
+{
+  if (meshlets.empty())
+    return;
+
+  Bind(command_buffer);
+
+  // Meshlets are contiguous in the index buffer, so runs of visible meshlets form one range
+  auto first_index = meshlets_[meshlets[0]].first_index;
+  auto num_indices = meshlets_[meshlets[0]].num_indices;
+  for (int i = 1; i < meshlets.size(); i++)
+  {
+    const auto& meshlet = meshlets_[meshlets[i]];
+    if (meshlet.first_index == first_index + num_indices)
+      num_indices += meshlet.num_indices;
+    else
+    {
+      command_buffer.drawIndexed(num_indices, 1, first_index, 0, 0);
+      first_index = meshlet.first_index;
+      num_indices = meshlet.num_indices;
+    }
+  }
+  command_buffer.drawIndexed(num_indices, 1, first_index, 0, 0);
+}
+
+void Mesh::Bind(vk::CommandBuffer& command_buffer)
+{
+  if (compressed_ || interleaved_)
+    command_buffer.bindVertexBuffers(0, { vertex_buffer_->Buffer() }, { 0ull });
+  else
+  {
+    command_buffer.bindVertexBuffers(0,
+      { vertex_buffer_->Buffer(), vertex_buffer_->Buffer() },
+      { vertex_buffer_->Offset(0), vertex_buffer_->Offset(1) });
+  }
+
+  command_buffer.bindIndexBuffer(vertex_buffer_->Buffer(), vertex_buffer_->IndexOffset(), vertex_buffer_->IndexType());
+}
+}
+}
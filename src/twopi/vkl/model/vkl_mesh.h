@@ -0,0 +1,95 @@
+#ifndef TWOPI_VKL_MODEL_VKL_MESH_H_
+#define TWOPI_VKL_MODEL_VKL_MESH_H_
+
+#include <array>
+#include <vector>
+
+#include <twopi/vkl/vkl_object.h>
+#include <twopi/vkl/vkl_memory.h>
+#include <twopi/geometry/mesh.h>
+#include <twopi/geometry/mesh_cache.h>
+
+namespace twopi
+{
+namespace vkl
+{
+class VertexBuffer;
+
+// GPU copy of a geometry::Mesh. Planar float meshes are uploaded as planar position/normal,
+// interleaved and compressed meshes as their interleaved vertices without repacking. Index buffers of
+// all levels of detail are concatenated after the full resolution indices.
+class Mesh : public Object
+{
+public:
+  struct Lod
+  {
+    uint32_t first_index = 0;
+    uint32_t num_indices = 0;
+    float error = 0.f;
+  };
+
+public:
+  Mesh() = delete;
+
+  Mesh(std::shared_ptr<vkl::Context> context, const geometry::Mesh& mesh);
+
+  // Copies mesh mesh_index of a mapped cache from the mapping into the stage buffer, without building a
+  // geometry::Mesh; view must stay alive until the constructor returns
+  Mesh(std::shared_ptr<vkl::Context> context, const geometry::MeshCache::View& view, int mesh_index);
+
+  ~Mesh();
+
+  bool IsCompressed() const { return compressed_; }
+
+  // Float vertices in geometry::Mesh's interleaved layout, in a single binding
+  bool IsInterleaved() const { return interleaved_; }
+
+  // Bytes of vertex and index data on the GPU
+  vk::DeviceSize BufferSize() const;
+
+  // Level 0 is full resolution
+  int NumLods() const { return static_cast<int>(lods_.size()); }
+  const Lod& GetLod(int level) const { return lods_[level]; }
+
+  // Coarsest level whose object space error does not exceed max_error
+  int SelectLod(float max_error) const;
+
+  // Object space bounding sphere
+  const std::array<float, 3>& Center() const { return center_; }
+  float Radius() const { return radius_; }
+
+  // Compressed positions are dequantized by offset + scale * position in the model matrix
+  const std::array<float, 3>& PositionOffset() const { return position_offset_; }
+  const std::array<float, 3>& PositionScale() const { return position_scale_; }
+
+  // Clusters of the full resolution level, empty if the mesh was not partitioned
+  const std::vector<geometry::Meshlet>& Meshlets() const { return meshlets_; }
+
+  void Draw(vk::CommandBuffer& command_buffer, int lod);
+
+  // Draws the given meshlets, sorted ascending; adjacent ones are merged into a single draw call
+  void DrawMeshlets(vk::CommandBuffer& command_buffer, const std::vector<uint32_t>& meshlets);
+
+private:
+  // Vertex buffer with the attribute layout of compressed_ and interleaved_
+  void CreateVertexBuffer(int num_vertices, uint32_t num_indices, bool short_indices);
+
+  void Bind(vk::CommandBuffer& command_buffer);
+
+  bool compressed_ = false;
+  bool interleaved_ = false;
+  std::vector<Lod> lods_;
+  std::vector<geometry::Meshlet> meshlets_;
+
+  std::array<float, 3> center_{ 0.f, 0.f, 0.f };
+  float radius_ = 0.f;
+
+  std::array<float, 3> position_offset_{ 0.f, 0.f, 0.f };
+  std::array<float, 3> position_scale_{ 1.f, 1.f, 1.f };
+
+  std::unique_ptr<VertexBuffer> vertex_buffer_;
+};
+}
+}
+
+#endif // TWOPI_VKL_MODEL_VKL_MESH_H_
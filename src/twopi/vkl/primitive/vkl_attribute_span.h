@@ -0,0 +1,23 @@
+#ifndef TWOPI_VKL_PRIMITIVE_VKL_ATTRIBUTE_SPAN_H_
+#define TWOPI_VKL_PRIMITIVE_VKL_ATTRIBUTE_SPAN_H_
+
+#include <cstddef>
+
+namespace twopi
+{
+namespace vkl
+{
+// Strided write access to a float vertex attribute, e.g. a planar region or an interleaved member of a
+// mapped stage buffer. Stride is in floats; a null span skips the attribute.
+struct AttributeSpan
+{
+  float* data = nullptr;
+  int stride = 0;
+
+  float* operator [] (size_t index) const { return data + index * stride; }
+  explicit operator bool() const { return data != nullptr; }
+};
+}
+}
+
+#endif // TWOPI_VKL_PRIMITIVE_VKL_ATTRIBUTE_SPAN_H_
@@ -5,33 +5,53 @@ namespace twopi
 namespace vkl
 {
 Floor::Floor(float range)
+  : range_(range)
 {
-  position_buffer_ = {
-    -range, -range, 0.f,
-    range, -range, 0.f,
-    -range, range, 0.f,
-    range, range, 0.f,
-  };
-
-  normal_buffer_ = {
-    0.f, 0.f, 1.f,
-    0.f, 0.f, 1.f,
-    0.f, 0.f, 1.f,
-    0.f, 0.f, 1.f,
-  };
-
-  tex_coord_buffer_ = {
-    -range, -range,
-    range, -range,
-    -range, range,
-    range, range,
-  };
-
-  index_buffer_ = {
-    0, 1, 2, 2, 1, 3
-  };
 }
 
 Floor::~Floor() = default;
+
+void Floor::Generate(AttributeSpan positions, AttributeSpan normals, AttributeSpan tex_coords) const
+{
+  for (int i = 0; i < 4; i++)
+  {
+    const float x = (i % 2 == 0) ? -range_ : range_;
+    const float y = (i / 2 == 0) ? -range_ : range_;
+
+    if (positions)
+    {
+      auto* p = positions[i];
+      p[0] = x;
+      p[1] = y;
+      p[2] = 0.f;
+    }
+
+    if (normals)
+    {
+      auto* n = normals[i];
+      n[0] = 0.f;
+      n[1] = 0.f;
+      n[2] = 1.f;
+    }
+
+    if (tex_coords)
+    {
+      auto* t = tex_coords[i];
+      t[0] = x;
+      t[1] = y;
+    }
+  }
+}
+
+template <typename T>
+void Floor::GenerateIndices(T* indices) const
+{
+  constexpr T floor_indices[] = { 0, 1, 2, 2, 1, 3 };
+  for (int i = 0; i < 6; i++)
+    indices[i] = floor_indices[i];
+}
+
+template void Floor::GenerateIndices(uint16_t* indices) const;
+template void Floor::GenerateIndices(uint32_t* indices) const;
 }
 }
@@ -1,12 +1,15 @@
 #ifndef TWOPI_VKL_PRIMITIVE_VKL_FLOOR_H_
 #define TWOPI_VKL_PRIMITIVE_VKL_FLOOR_H_
 
-#include <vector>
+#include <cstdint>
+
+#include <twopi/vkl/primitive/vkl_attribute_span.h>
 
 namespace twopi
 {
 namespace vkl
 {
+// Square on the z = 0 plane, generated directly into caller-provided buffers
 class Floor
 {
 public:
@@ -16,19 +19,18 @@ public:
 
   ~Floor();
 
-  const int NumVertices() const { return static_cast<int>(position_buffer_.size() / 3); }
-  const int NumIndices() const { return static_cast<int>(index_buffer_.size()); }
+  int NumVertices() const { return 4; }
+  int NumIndices() const { return 6; }
+
+  // Tex coords are the xy positions, so that textures repeat per unit length
+  void Generate(AttributeSpan positions, AttributeSpan normals, AttributeSpan tex_coords) const;
 
-  const auto& PositionBuffer() const { return position_buffer_; }
-  const auto& NormalBuffer() const { return normal_buffer_; }
-  const auto& TexCoordBuffer() const { return tex_coord_buffer_; }
-  const auto& IndexBuffer() const { return index_buffer_; }
+  // T is uint16_t or uint32_t
+  template <typename T>
+  void GenerateIndices(T* indices) const;
 
 private:
-  std::vector<float> position_buffer_;
-  std::vector<float> normal_buffer_;
-  std::vector<float> tex_coord_buffer_;
-  std::vector<uint32_t> index_buffer_;
+  float range_;
 };
 }
 }
@@ -1,6 +1,8 @@
 #include <twopi/vkl/primitive/vkl_sphere.h>
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 #include <glm/ext.hpp>
 
@@ -9,60 +11,96 @@ namespace twopi
 namespace vkl
 {
 Sphere::Sphere(int segments)
+  : segments_(std::max(segments, 3))
 {
-  const uint32_t top_index = segments * (segments - 1);
-  const uint32_t bottom_index = top_index + 1;
+}
+
+Sphere::~Sphere() = default;
+
+void Sphere::Generate(AttributeSpan positions, AttributeSpan normals) const
+{
+  const auto segments = segments_;
+
+  // Trigonometry per meridian and per ring, instead of per vertex
+  std::vector<float> cos_theta(segments);
+  std::vector<float> sin_theta(segments);
   for (int i = 0; i < segments; i++)
   {
-    index_buffer_.push_back(top_index);
-    index_buffer_.push_back(i * (segments - 1));
-    index_buffer_.push_back(((i + 1) % segments) * (segments - 1));
+    const float theta = static_cast<float>(i) / segments * 2.f * glm::pi<float>();
+    cos_theta[i] = std::cos(theta);
+    sin_theta[i] = std::sin(theta);
+  }
 
-    const float u = static_cast<float>(i) / segments;
-    const float theta = u * 2.f * glm::pi<float>();
-    for (int j = 1; j < segments; j++)
+  std::vector<float> cos_phi(segments);
+  std::vector<float> sin_phi(segments);
+  for (int j = 1; j < segments; j++)
+  {
+    const float phi = static_cast<float>(j) / segments * glm::pi<float>();
+    cos_phi[j] = std::cos(phi);
+    sin_phi[j] = std::sin(phi);
+  }
+
+  const auto write = [&positions, &normals](size_t vertex, float x, float y, float z) {
+    if (positions)
+    {
+      auto* p = positions[vertex];
+      p[0] = x;
+      p[1] = y;
+      p[2] = z;
+    }
+
+    if (normals)
     {
-      const float v = static_cast<float>(j) / segments;
-      const float phi = v * glm::pi<float>();
-      position_buffer_.push_back(std::cos(theta) * std::sin(phi));
-      position_buffer_.push_back(std::sin(theta) * std::sin(phi));
-      position_buffer_.push_back(std::cos(phi));
-      normal_buffer_.push_back(std::cos(theta) * std::sin(phi));
-      normal_buffer_.push_back(std::sin(theta) * std::sin(phi));
-      normal_buffer_.push_back(std::cos(phi));
-
-      if (j < segments - 1)
-      {
-        index_buffer_.push_back(i * (segments - 1) + j - 1);
-        index_buffer_.push_back(i * (segments - 1) + j);
-        index_buffer_.push_back(((i + 1) % segments) * (segments - 1) + j - 1);
-
-        index_buffer_.push_back(i * (segments - 1) + j);
-        index_buffer_.push_back(((i + 1) % segments) * (segments - 1) + j);
-        index_buffer_.push_back(((i + 1) % segments) * (segments - 1) + j - 1);
-      }
+      auto* n = normals[vertex];
+      n[0] = x;
+      n[1] = y;
+      n[2] = z;
     }
+  };
 
-    index_buffer_.push_back(i * (segments - 1) + segments - 2);
-    index_buffer_.push_back(bottom_index);
-    index_buffer_.push_back(((i + 1) % segments) * (segments - 1) + segments - 2);
+  size_t vertex = 0;
+  for (int i = 0; i < segments; i++)
+  {
+    for (int j = 1; j < segments; j++)
+      write(vertex++, cos_theta[i] * sin_phi[j], sin_theta[i] * sin_phi[j], cos_phi[j]);
   }
 
-  position_buffer_.push_back(0.f);
-  position_buffer_.push_back(0.f);
-  position_buffer_.push_back(1.f);
-  normal_buffer_.push_back(0.f);
-  normal_buffer_.push_back(0.f);
-  normal_buffer_.push_back(1.f);
-
-  position_buffer_.push_back(0.f);
-  position_buffer_.push_back(0.f);
-  position_buffer_.push_back(-1.f);
-  normal_buffer_.push_back(0.f);
-  normal_buffer_.push_back(0.f);
-  normal_buffer_.push_back(-1.f);
+  write(vertex++, 0.f, 0.f, 1.f);
+  write(vertex++, 0.f, 0.f, -1.f);
 }
 
-Sphere::~Sphere() = default;
+template <typename T>
+void Sphere::GenerateIndices(T* indices) const
+{
+  const auto segments = static_cast<uint32_t>(segments_);
+  const auto ring = segments - 1;
+  const uint32_t top_index = segments * ring;
+  const uint32_t bottom_index = top_index + 1;
+
+  auto* index = indices;
+  const auto triangle = [&index](uint32_t i0, uint32_t i1, uint32_t i2) {
+    index[0] = static_cast<T>(i0);
+    index[1] = static_cast<T>(i1);
+    index[2] = static_cast<T>(i2);
+    index += 3;
+  };
+
+  for (uint32_t i = 0; i < segments; i++)
+  {
+    const auto current = i * ring;
+    const auto next = ((i + 1) % segments) * ring;
+
+    triangle(top_index, current, next);
+    for (uint32_t j = 1; j + 1 < segments; j++)
+    {
+      triangle(current + j - 1, current + j, next + j - 1);
+      triangle(current + j, next + j, next + j - 1);
+    }
+    triangle(current + segments - 2, bottom_index, next + segments - 2);
+  }
+}
+
+template void Sphere::GenerateIndices(uint16_t* indices) const;
+template void Sphere::GenerateIndices(uint32_t* indices) const;
 }
 }
@@ -1,12 +1,15 @@
 #ifndef TWOPI_VKL_PRIMITIVE_VKL_SPHERE_H_
 #define TWOPI_VKL_PRIMITIVE_VKL_SPHERE_H_
 
-#include <vector>
+#include <cstdint>
+
+#include <twopi/vkl/primitive/vkl_attribute_span.h>
 
 namespace twopi
 {
 namespace vkl
 {
+// Unit UV sphere around the z axis, generated directly into caller-provided buffers
 class Sphere
 {
 public:
@@ -16,17 +19,18 @@ public:
 
   ~Sphere();
 
-  const int NumVertices() const { return static_cast<int>(position_buffer_.size() / 3); }
-  const int NumIndices() const { return static_cast<int>(index_buffer_.size()); }
+  // Rings of segments - 1 vertices around each of segments meridians, and the two poles
+  int NumVertices() const { return segments_ * (segments_ - 1) + 2; }
+  int NumIndices() const { return 6 * segments_ * (segments_ - 1); }
+
+  void Generate(AttributeSpan positions, AttributeSpan normals) const;
 
-  const auto& PositionBuffer() const { return position_buffer_; }
-  const auto& NormalBuffer() const { return normal_buffer_; }
-  const auto& IndexBuffer() const { return index_buffer_; }
+  // T is uint16_t or uint32_t
+  template <typename T>
+  void GenerateIndices(T* indices) const;
 
 private:
-  std::vector<float> position_buffer_;
-  std::vector<float> normal_buffer_;
-  std::vector<uint32_t> index_buffer_;
+  int segments_;
 };
 }
 }
@@ -1,37 +1,80 @@
 #include <twopi/vkl/primitive/vkl_surface.h>
 
+#include <algorithm>
+
 namespace twopi
 {
 namespace vkl
 {
 Surface::Surface()
+  : Surface(2)
+{
+}
+
+Surface::Surface(int patches)
+  : patches_(std::max(patches, 1))
+{
+}
+
+Surface::~Surface() = default;
+
+void Surface::Generate(AttributeSpan positions, AttributeSpan vx, AttributeSpan vy) const
 {
-  for (int i = 0; i < 3; i++)
+  // Centered on the origin with 2 units per patch
+  const auto size = patches_ + 1;
+  const auto center = patches_ * 0.5f;
+  for (int i = 0; i < size; i++)
   {
-    for (int j = 0; j < 3; j++)
+    for (int j = 0; j < size; j++)
     {
-      position_buffer_.push_back((j - 1) * 2.f);
-      position_buffer_.push_back(0.f);
-      position_buffer_.push_back((i - 1) * 2.f);
+      const auto vertex = static_cast<size_t>(i) * size + j;
 
-      vx_buffer_.push_back(2.f);
-      vx_buffer_.push_back(2.f);
-      vx_buffer_.push_back(0.f);
+      if (positions)
+      {
+        auto* p = positions[vertex];
+        p[0] = (j - center) * 2.f;
+        p[1] = 0.f;
+        p[2] = (i - center) * 2.f;
+      }
 
-      vy_buffer_.push_back(0.f);
-      vy_buffer_.push_back(2.f);
-      vy_buffer_.push_back(2.f);
+      if (vx)
+      {
+        auto* v = vx[vertex];
+        v[0] = 2.f;
+        v[1] = 2.f;
+        v[2] = 0.f;
+      }
+
+      if (vy)
+      {
+        auto* v = vy[vertex];
+        v[0] = 0.f;
+        v[1] = 2.f;
+        v[2] = 2.f;
+      }
     }
   }
+}
 
-  index_buffer_ = {
-    0, 1, 3, 4,
-    1, 2, 4, 5,
-    3, 4, 6, 7,
-    4, 5, 7, 8,
-  };
+template <typename T>
+void Surface::GenerateIndices(T* indices) const
+{
+  const auto size = static_cast<uint32_t>(patches_ + 1);
+  auto* index = indices;
+  for (uint32_t i = 0; i < static_cast<uint32_t>(patches_); i++)
+  {
+    for (uint32_t j = 0; j < static_cast<uint32_t>(patches_); j++)
+    {
+      index[0] = static_cast<T>(i * size + j);
+      index[1] = static_cast<T>(i * size + j + 1);
+      index[2] = static_cast<T>((i + 1) * size + j);
+      index[3] = static_cast<T>((i + 1) * size + j + 1);
+      index += 4;
+    }
+  }
 }
 
-Surface::~Surface() = default;
+template void Surface::GenerateIndices(uint16_t* indices) const;
+template void Surface::GenerateIndices(uint32_t* indices) const;
 }
 }
@@ -1,33 +1,37 @@
 #ifndef TWOPI_VKL_PRIMITIVE_VKL_SURFACE_H_
 #define TWOPI_VKL_PRIMITIVE_VKL_SURFACE_H_
 
-#include <vector>
+#include <cstdint>
+
+#include <twopi/vkl/primitive/vkl_attribute_span.h>
 
 namespace twopi
 {
 namespace vkl
 {
+// Grid of bicubic patches on the y = 0 plane, with tangents per control point, generated directly into
+// caller-provided buffers
 class Surface
 {
 public:
   Surface();
 
+  explicit Surface(int patches);
+
   ~Surface();
 
-  const int NumVertices() const { return static_cast<int>(position_buffer_.size() / 3); }
-  const int NumIndices() const { return static_cast<int>(index_buffer_.size()); }
+  // Control points of patches x patches quads, 4 indices per patch: p00, p10, p01, p11
+  int NumVertices() const { return (patches_ + 1) * (patches_ + 1); }
+  int NumIndices() const { return 4 * patches_ * patches_; }
+
+  void Generate(AttributeSpan positions, AttributeSpan vx, AttributeSpan vy) const;
 
-  const auto& PositionBuffer() const { return position_buffer_; }
-  const auto& VxBuffer() const { return vx_buffer_; }
-  const auto& VyBuffer() const { return vy_buffer_; }
-  const auto& IndexBuffer() const { return index_buffer_; }
+  // T is uint16_t or uint32_t
+  template <typename T>
+  void GenerateIndices(T* indices) const;
 
 private:
-  // p00, p10, p01, p11
-  std::vector<float> position_buffer_;
-  std::vector<float> vx_buffer_;
-  std::vector<float> vy_buffer_;
-  std::vector<uint32_t> index_buffer_;
+  int patches_;
 };
 }
 }
@@ -1,5 +1,7 @@
 #include <twopi/vkl/vkl_context.h>
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
 #define GLFW_INCLUDE_VULKAN
@@ -153,6 +155,16 @@ void Context::CreateDevice()
     VK_KHR_SWAPCHAIN_EXTENSION_NAME
   };
 
+  // Heap budgets for memory statistics, where supported
+  for (const auto& extension : physical_device_.enumerateDeviceExtensionProperties())
+  {
+    if (std::strcmp(extension.extensionName, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) == 0)
+    {
+      extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+      has_memory_budget_ = true;
+    }
+  }
+
   // Device features
   auto features = physical_device_.getFeatures();
   features
@@ -201,25 +213,167 @@ void Context::DestroyCommandPools()
 
 void Context::CreateStageBuffer()
 {
-  // Create stage buffer
   stage_buffer_ = std::make_unique<StageBuffer>(this);
-
-  // Transfer command buffer
-  transfer_command_buffer_ = AllocateTransientCommandBuffers(1)[0];
-
-  // Transfer fence
-  vk::FenceCreateInfo fence_create_info;
-  fence_create_info
-    .setFlags(vk::FenceCreateFlagBits::eSignaled);
-  transfer_fence_ = device_.createFence(fence_create_info);
 }
 
 void Context::DestroyStageBuffer()
 {
-  device_.destroyFence(transfer_fence_);
+  // Uploads never flushed may target resources already destroyed, so they are dropped rather than submitted
+  if (recording_upload_)
+  {
+    recording_upload_->command_buffer.end();
+    for (const auto& temporary_buffer : recording_upload_->temporary_buffers)
+    {
+      device_.destroyBuffer(temporary_buffer.buffer);
+      FreeMemory(temporary_buffer.memory);
+    }
+    free_uploads_.push_back(std::move(*recording_upload_));
+    recording_upload_.reset();
+  }
+
+  while (!submitted_uploads_.empty())
+    RetireUploads(true);
+
+  for (auto& upload : free_uploads_)
+  {
+    device_.destroyFence(upload.fence);
+    device_.freeCommandBuffers(transient_command_pool_, upload.command_buffer);
+  }
+  free_uploads_.clear();
+
   stage_buffer_.reset();
 }
 
+Context& Context::ToGpu(const void* data, vk::DeviceSize size, vk::Buffer buffer, vk::DeviceSize offset)
+{
+  const auto chunk_size = stage_buffer_->Size();
+  for (vk::DeviceSize chunk_offset = 0; chunk_offset < size; chunk_offset += chunk_size)
+  {
+    const auto copy_size = std::min(chunk_size, size - chunk_offset);
+    ToGpu(copy_size, buffer, offset + chunk_offset, [data, chunk_offset, copy_size](void* map) {
+      std::memcpy(map, static_cast<const uint8_t*>(data) + chunk_offset, copy_size);
+      });
+  }
+
+  return *this;
+}
+
+void Context::FlushUploads()
+{
+  if (!recording_upload_)
+    return;
+
+  auto& upload = *recording_upload_;
+
+  // Copies are visible to any command submitted later on the queue
+  vk::MemoryBarrier barrier;
+  barrier
+    .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+    .setDstAccessMask(vk::AccessFlagBits::eMemoryRead);
+  upload.command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eAllCommands, {},
+    barrier, nullptr, nullptr);
+
+  upload.command_buffer.end();
+  upload.stage_head = stage_buffer_->Head();
+
+  vk::SubmitInfo submit_info;
+  submit_info
+    .setCommandBuffers(upload.command_buffer);
+  queue_.submit(submit_info, upload.fence);
+
+  submitted_uploads_.push_back(std::move(upload));
+  recording_upload_.reset();
+}
+
+Context::StageRegion Context::AllocateStage(vk::DeviceSize size)
+{
+  // Buffer image copies need offsets aligned to 4 bytes and to the texel block size
+  constexpr vk::DeviceSize stage_alignment = 16;
+
+  RetireUploads(false);
+
+  if (size > stage_buffer_->Size())
+  {
+    vk::BufferCreateInfo buffer_create_info;
+    buffer_create_info
+      .setSharingMode(vk::SharingMode::eExclusive)
+      .setUsage(vk::BufferUsageFlagBits::eTransferSrc)
+      .setSize(size);
+    const auto buffer = device_.createBuffer(buffer_create_info);
+
+    const auto memory = AllocatePersistentlyMappedMemory(buffer, MemoryCategory::STAGING);
+    device_.bindBufferMemory(buffer, memory.device_memory, memory.offset);
+
+    UploadCommandBuffer();
+    recording_upload_->temporary_buffers.push_back({ buffer, memory });
+    return { buffer, 0, memory.map };
+  }
+
+  auto offset = stage_buffer_->Allocate(size, stage_alignment);
+  while (offset == StageBuffer::invalid_offset)
+  {
+    // Full of copies not yet run; the recorded ones are submitted so that their space can be waited for
+    FlushUploads();
+    RetireUploads(true);
+    offset = stage_buffer_->Allocate(size, stage_alignment);
+  }
+
+  return { stage_buffer_->Buffer(), offset, static_cast<uint8_t*>(static_cast<void*>(*stage_buffer_)) + offset };
+}
+
+vk::CommandBuffer Context::UploadCommandBuffer()
+{
+  if (!recording_upload_)
+  {
+    if (free_uploads_.empty())
+    {
+      UploadBatch upload;
+      upload.command_buffer = AllocateTransientCommandBuffers(1)[0];
+      upload.fence = device_.createFence({});
+      recording_upload_ = std::move(upload);
+    }
+    else
+    {
+      recording_upload_ = std::move(free_uploads_.back());
+      free_uploads_.pop_back();
+      device_.resetFences(recording_upload_->fence);
+      recording_upload_->command_buffer.reset();
+    }
+
+    vk::CommandBufferBeginInfo begin_info;
+    begin_info.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+    recording_upload_->command_buffer.begin(begin_info);
+  }
+
+  return recording_upload_->command_buffer;
+}
+
+void Context::RetireUploads(bool wait)
+{
+  while (!submitted_uploads_.empty())
+  {
+    auto& upload = submitted_uploads_.front();
+    if (wait)
+    {
+      device_.waitForFences(upload.fence, true, UINT64_MAX);
+      wait = false;
+    }
+    else if (device_.getFenceStatus(upload.fence) != vk::Result::eSuccess)
+      break;
+
+    stage_buffer_->Release(upload.stage_head);
+    for (const auto& temporary_buffer : upload.temporary_buffers)
+    {
+      device_.destroyBuffer(temporary_buffer.buffer);
+      FreeMemory(temporary_buffer.memory);
+    }
+    upload.temporary_buffers.clear();
+
+    free_uploads_.push_back(std::move(upload));
+    submitted_uploads_.pop_front();
+  }
+}
+
 std::vector<uint32_t> Context::QueueFamilyIndices() const
 {
   return std::vector<uint32_t>{
@@ -227,24 +381,49 @@ std::vector<uint32_t> Context::QueueFamilyIndices() const
   };
 }
 
-Memory Context::AllocateDeviceMemory(vk::Buffer buffer)
+Memory Context::AllocateDeviceMemory(vk::Buffer buffer, MemoryCategory category)
+{
+  return memory_manager_->AllocateDeviceMemory(buffer, category);
+}
+
+Memory Context::AllocateDeviceMemory(vk::Image image, MemoryCategory category)
+{
+  return memory_manager_->AllocateDeviceMemory(image, category);
+}
+
+Memory Context::AllocateVertexMemory(vk::Buffer buffer, vk::DeviceSize index_size)
+{
+  return memory_manager_->AllocateVertexMemory(buffer, index_size);
+}
+
+Memory Context::AllocateHostMemory(vk::Buffer buffer, MemoryCategory category)
+{
+  return memory_manager_->AllocateHostMemory(buffer, category);
+}
+
+Memory Context::AllocateReadbackMemory(vk::Buffer buffer, MemoryCategory category)
+{
+  return memory_manager_->AllocateReadbackMemory(buffer, category);
+}
+
+Memory Context::AllocateTransientMemory(vk::Image image, MemoryCategory category)
 {
-  return memory_manager_->AllocateDeviceMemory(buffer);
+  return memory_manager_->AllocateTransientMemory(image, category);
 }
 
-Memory Context::AllocateDeviceMemory(vk::Image image)
+Memory Context::AllocatePersistentlyMappedMemory(vk::Buffer buffer, MemoryCategory category)
 {
-  return memory_manager_->AllocateDeviceMemory(image);
+  return memory_manager_->AllocatePersistentlyMappedMemory(buffer, category);
 }
 
-Memory Context::AllocateHostMemory(vk::Buffer buffer)
+void Context::FreeMemory(const Memory& memory)
 {
-  return memory_manager_->AllocateHostMemory(buffer);
+  memory_manager_->Free(memory);
 }
 
-Memory Context::AllocatePersistentlyMappedMemory(vk::Buffer buffer)
+vkl::MemoryStatistics Context::MemoryStatistics() const
 {
-  return memory_manager_->AllocatePersistentlyMappedMemory(buffer);
+  return memory_manager_->Statistics();
 }
 
 std::vector<vk::CommandBuffer> Context::AllocateCommandBuffers(int count)
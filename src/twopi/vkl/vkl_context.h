@@ -1,10 +1,13 @@
 #ifndef TWOPI_VKL_VKL_CONTEXT_H_
 #define TWOPI_VKL_VKL_CONTEXT_H_
 
+#include <deque>
 #include <optional>
 #include <vector>
 
 #include <vulkan/vulkan.hpp>
+#include <twopi/vkl/vkl_memory.h>
+#include <twopi/vkl/vkl_memory_statistics.h>
 #include <twopi/vkl/vkl_stage_buffer.h>
 
 struct GLFWwindow;
@@ -13,7 +16,6 @@ namespace twopi
 {
 namespace vkl
 {
-struct Memory;
 class MemoryManager;
 
 class Context
@@ -31,10 +33,20 @@ public:
 
   std::vector<uint32_t> QueueFamilyIndices() const;
 
-  [[nodiscard]] Memory AllocateDeviceMemory(vk::Buffer buffer);
-  [[nodiscard]] Memory AllocateDeviceMemory(vk::Image image);
-  [[nodiscard]] Memory AllocateHostMemory(vk::Buffer buffer);
-  [[nodiscard]] Memory AllocatePersistentlyMappedMemory(vk::Buffer buffer);
+  [[nodiscard]] Memory AllocateDeviceMemory(vk::Buffer buffer, MemoryCategory category);
+  [[nodiscard]] Memory AllocateDeviceMemory(vk::Image image, MemoryCategory category);
+  [[nodiscard]] Memory AllocateVertexMemory(vk::Buffer buffer, vk::DeviceSize index_size);
+  [[nodiscard]] Memory AllocateHostMemory(vk::Buffer buffer, MemoryCategory category);
+  [[nodiscard]] Memory AllocateReadbackMemory(vk::Buffer buffer, MemoryCategory category);
+  [[nodiscard]] Memory AllocateTransientMemory(vk::Image image, MemoryCategory category);
+  [[nodiscard]] Memory AllocatePersistentlyMappedMemory(vk::Buffer buffer, MemoryCategory category);
+
+  // Device or host memory returned to the memory manager, after the resource bound to it is destroyed
+  void FreeMemory(const Memory& memory);
+
+  // Whether VK_EXT_memory_budget is enabled, for the heap budgets in MemoryStatistics
+  auto HasMemoryBudget() const { return has_memory_budget_; }
+  vkl::MemoryStatistics MemoryStatistics() const;
 
   std::vector<vk::CommandBuffer> AllocateCommandBuffers(int count);
   std::vector<vk::CommandBuffer> AllocateTransientCommandBuffers(int count);
@@ -42,40 +54,100 @@ public:
   void FreeCommandBuffers(std::vector<vk::CommandBuffer>&& command_buffers);
   void FreeTransientCommandBuffers(std::vector<vk::CommandBuffer>&& command_buffers);
 
+  // Uploads below are recorded into a batch and run once FlushUploads submits it, or earlier when the stage
+  // buffer is full. They only block while the stage buffer is full of copies still in flight.
   template <typename T>
   Context& ToGpu(const std::vector<T>& data, vk::Buffer buffer, vk::DeviceSize offset)
   {
-    device_.waitForFences(transfer_fence_, true, UINT64_MAX);
-    device_.resetFences(transfer_fence_);
+    return ToGpu(data.data(), data.size() * sizeof(T), buffer, offset);
+  }
 
-    std::memcpy(*stage_buffer_, data.data(), data.size() * sizeof(T));
+  // Copies size bytes of data, in chunks when larger than the stage buffer
+  Context& ToGpu(const void* data, vk::DeviceSize size, vk::Buffer buffer, vk::DeviceSize offset);
+
+  // Copies size bytes that write(void* map) fills in the mapped stage buffer, e.g. generated vertices,
+  // without an intermediate host copy unless size exceeds the stage buffer
+  template <typename F>
+  Context& ToGpu(vk::DeviceSize size, vk::Buffer buffer, vk::DeviceSize offset, F&& write)
+  {
+    if (size == 0)
+      return *this;
 
-    transfer_command_buffer_.reset();
+    if (size > stage_buffer_->Size())
+    {
+      std::vector<uint8_t> data(size);
+      write(data.data());
+      return ToGpu(data.data(), size, buffer, offset);
+    }
 
-    vk::CommandBufferBeginInfo begin_info;
-    begin_info.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
-    transfer_command_buffer_.begin(begin_info);
+    const auto stage = AllocateStage(size);
+    write(stage.map);
 
     vk::BufferCopy region;
     region
-      .setSrcOffset(0)
+      .setSrcOffset(stage.offset)
       .setDstOffset(offset)
-      .setSize(data.size() * sizeof(T));
+      .setSize(size);
 
-    transfer_command_buffer_
-      .copyBuffer(stage_buffer_->Buffer(), buffer, region);
+    UploadCommandBuffer()
+      .copyBuffer(stage.buffer, buffer, region);
 
-    transfer_command_buffer_.end();
-
-    vk::SubmitInfo submit_info;
-    submit_info
-      .setCommandBuffers(transfer_command_buffer_);
+    return *this;
+  }
 
-    queue_.submit(submit_info, transfer_fence_);
+  // Copies regions that write(void* map) fills in the stage buffer into the first num_levels mip levels of a color
+  // image, and leaves those levels in shader read-only layout
+  template <typename F>
+  Context& ToGpu(vk::DeviceSize size, vk::Image image, uint32_t num_levels, const std::vector<vk::BufferImageCopy>& regions, F&& write)
+  {
+    const auto stage = AllocateStage(size);
+    write(stage.map);
+
+    auto stage_regions = regions;
+    for (auto& region : stage_regions)
+      region.bufferOffset += stage.offset;
+
+    const auto command_buffer = UploadCommandBuffer();
+
+    vk::ImageSubresourceRange subresource_range;
+    subresource_range
+      .setAspectMask(vk::ImageAspectFlagBits::eColor)
+      .setBaseMipLevel(0)
+      .setLevelCount(num_levels)
+      .setBaseArrayLayer(0)
+      .setLayerCount(1);
+
+    vk::ImageMemoryBarrier barrier;
+    barrier
+      .setImage(image)
+      .setSubresourceRange(subresource_range)
+      .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+      .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
+      .setOldLayout(vk::ImageLayout::eUndefined)
+      .setNewLayout(vk::ImageLayout::eTransferDstOptimal)
+      .setDstAccessMask(vk::AccessFlagBits::eTransferWrite);
+
+    command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer, {},
+      nullptr, nullptr, barrier);
+
+    command_buffer
+      .copyBufferToImage(stage.buffer, image, vk::ImageLayout::eTransferDstOptimal, stage_regions);
+
+    barrier
+      .setOldLayout(vk::ImageLayout::eTransferDstOptimal)
+      .setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
+      .setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)
+      .setDstAccessMask(vk::AccessFlagBits::eShaderRead);
+
+    command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader, {},
+      nullptr, nullptr, barrier);
 
     return *this;
   }
 
+  // Submits recorded uploads without waiting, ordered before anything submitted to the queue afterwards
+  void FlushUploads();
+
 private:
   void CreateInstance(GLFWwindow* glfw_window);
   void DestroyInstance();
@@ -89,6 +161,23 @@ private:
   void CreateStageBuffer();
   void DestroyStageBuffer();
 
+  struct StageRegion
+  {
+    vk::Buffer buffer;
+    vk::DeviceSize offset = 0;
+    void* map = nullptr;
+  };
+
+  // Region of the stage buffer, or of a temporary buffer released with the batch if size exceeds the stage buffer.
+  // Only image copies, whose regions cannot be split by size, need the temporary buffer.
+  StageRegion AllocateStage(vk::DeviceSize size);
+
+  // Command buffer of the batch being recorded, begun on first use
+  vk::CommandBuffer UploadCommandBuffer();
+
+  // Recycles batches whose fences have signaled, first waiting for the oldest one if wait is set
+  void RetireUploads(bool wait);
+
   vk::Instance instance_;
   vk::DebugUtilsMessengerEXT messenger_;
   vk::SurfaceKHR surface_;
@@ -99,13 +188,29 @@ private:
   vk::Queue present_queue_;
 
   std::optional<uint32_t> queue_index_;
+  bool has_memory_budget_ = false;
 
   std::unique_ptr<MemoryManager> memory_manager_;
 
   // Stage buffer
+  struct UploadBatch
+  {
+    struct TemporaryBuffer
+    {
+      vk::Buffer buffer;
+      Memory memory;
+    };
+
+    vk::CommandBuffer command_buffer;
+    vk::Fence fence;
+    vk::DeviceSize stage_head = 0;
+    std::vector<TemporaryBuffer> temporary_buffers;
+  };
+
   std::unique_ptr<StageBuffer> stage_buffer_;
-  vk::CommandBuffer transfer_command_buffer_;
-  vk::Fence transfer_fence_;
+  std::optional<UploadBatch> recording_upload_;
+  std::deque<UploadBatch> submitted_uploads_;
+  std::vector<UploadBatch> free_uploads_;
 
   // Command pool
   vk::CommandPool command_pool_;
@@ -1,5 +1,8 @@
 #include <twopi/vkl/vkl_engine.h>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <iostream>
 #include <fstream>
 #include <optional>
@@ -19,6 +22,7 @@
 #include <twopi/vkl/vkl_uniform_buffer.h>
 #include <twopi/vkl/vkl_vertex_buffer.h>
 #include <twopi/vkl/model/vkl_cubeskin.h>
+#include <twopi/vkl/model/vkl_mesh.h>
 #include <twopi/vkl/primitive/vkl_sphere.h>
 #include <twopi/vkl/primitive/vkl_floor.h>
 #include <twopi/core/error.h>
@@ -27,7 +31,9 @@
 #include <twopi/scene/camera.h>
 #include <twopi/scene/light.h>
 #include <twopi/geometry/mesh.h>
+#include <twopi/geometry/mesh_cache.h>
 #include <twopi/geometry/mesh_loader.h>
+#include <twopi/geometry/model.h>
 
 namespace twopi
 {
@@ -86,6 +92,26 @@ private:
     float shininess; // Padded
   };
 
+  struct MeshObject
+  {
+    std::unique_ptr<vkl::Mesh> mesh;
+    glm::mat4 transform;
+    glm::mat4 transform_inverse;
+    // Largest axis scale of the transform, for world space bounding spheres
+    float scale = 1.f;
+    ModelUbo model;
+    int lod = 0;
+    bool visible = true;
+  };
+
+  struct PendingModel
+  {
+    std::future<std::shared_ptr<geometry::Model>> future;
+    std::shared_ptr<geometry::Model> model;
+    glm::mat4 transform;
+    int next_mesh = 0;
+  };
+
   // Compute shader - Binding 2
   struct CubeskinSimulationUbo
   {
@@ -113,9 +139,7 @@ public:
     max_width_ = window->MaxWidth();
     max_height_ = window->MaxHeight();
 
-    mip_levels_ = 3;
-
-    num_objects_ = 3; // One floor, one light, one cubeskin
+    num_objects_ = 3 + max_num_mesh_objects; // One floor, one light, one cubeskin, then meshes
 
     material_.specular = glm::vec3(1.f, 1.f, 1.f);
     material_.shininess = 64.f;
@@ -169,6 +193,8 @@ public:
 
     device.resetFences(in_flight_fences_[current_frame_]);
 
+    StreamModels();
+
     // Rebuild command buffers
     auto& command_buffer = draw_command_buffers_[image_index];
     BuildDrawCommandBuffer(command_buffer, image_index);
@@ -179,9 +205,14 @@ public:
     model_ubos_[image_index][0] = floor_model_;
     model_ubos_[image_index][1] = light_model_;
     model_ubos_[image_index][2] = cubeskin_model_;
+    for (int i = 0; i < mesh_objects_.size(); i++)
+      model_ubos_[image_index][3 + i] = mesh_objects_[i].model;
     material_ubos_[image_index] = material_;
     cubeskin_simulation_ubos_[image_index] = cubeskin_simulation_;
 
+    // Uploads recorded since the last frame, e.g. streamed meshes, run before the frame reads them
+    context_->FlushUploads();
+
     // Submit to graphics queue
     command_buffer.end();
 
@@ -269,6 +300,42 @@ public:
     camera_.eye = camera->Eye();
   }
 
+  void AddModel(std::shared_ptr<geometry::Model> model, const glm::mat4& transform)
+  {
+    if (mesh_objects_.size() + model->NumMeshes() > max_num_mesh_objects)
+      throw core::Error("Too many meshes: maximum " + std::to_string(max_num_mesh_objects));
+
+    for (const auto& mesh : model->Meshes())
+      AddMesh(std::make_unique<vkl::Mesh>(context_, *mesh), transform);
+  }
+
+  void AddModel(const geometry::MeshCache::View& view, const glm::mat4& transform)
+  {
+    if (mesh_objects_.size() + view.NumMeshes() > max_num_mesh_objects)
+      throw core::Error("Too many meshes: maximum " + std::to_string(max_num_mesh_objects));
+
+    for (int i = 0; i < view.NumMeshes(); i++)
+      AddMesh(std::make_unique<vkl::Mesh>(context_, view, i), transform);
+  }
+
+  void AddModel(std::future<std::shared_ptr<geometry::Model>>&& model, const glm::mat4& transform)
+  {
+    PendingModel pending_model;
+    pending_model.future = std::move(model);
+    pending_model.transform = transform;
+    pending_models_.emplace_back(std::move(pending_model));
+  }
+
+  void SetUploadBudget(uint64_t upload_budget)
+  {
+    upload_budget_ = upload_budget;
+  }
+
+  void SetLodPixelError(float pixel_error)
+  {
+    lod_pixel_error_ = pixel_error;
+  }
+
   void SetDrawSolid()
   {
     draw_mode_ = DrawMode::SOLID;
@@ -285,6 +352,163 @@ public:
   }
 
 private:
+  void AddMesh(std::unique_ptr<vkl::Mesh> mesh, const glm::mat4& transform)
+  {
+    MeshObject object;
+    object.mesh = std::move(mesh);
+    object.transform = transform;
+    object.transform_inverse = glm::inverse(transform);
+    object.scale = std::max({
+      glm::length(glm::vec3(transform[0])),
+      glm::length(glm::vec3(transform[1])),
+      glm::length(glm::vec3(transform[2])) });
+
+    // Dequantization of compressed positions is folded into the model matrix, but not into the normal matrix
+    const auto& offset = object.mesh->PositionOffset();
+    const auto& scale = object.mesh->PositionScale();
+    object.model.model = transform;
+    if (object.mesh->IsCompressed())
+    {
+      object.model.model = transform *
+        glm::translate(glm::vec3{ offset[0], offset[1], offset[2] }) *
+        glm::scale(glm::vec3{ scale[0], scale[1], scale[2] });
+    }
+    object.model.model_inverse_transpose = glm::inverse(glm::transpose(transform));
+
+    mesh_objects_.emplace_back(std::move(object));
+  }
+
+  // Uploads meshes of ready pending models, oldest first, until the frame's upload budget is spent
+  void StreamModels()
+  {
+    uint64_t uploaded = 0;
+    for (auto it = pending_models_.begin(); it != pending_models_.end() && uploaded < upload_budget_;)
+    {
+      auto& pending_model = *it;
+      if (pending_model.model == nullptr)
+      {
+        if (pending_model.future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+          ++it;
+          continue;
+        }
+
+        try
+        {
+          pending_model.model = pending_model.future.get();
+        }
+        catch (const std::exception& e)
+        {
+          std::cerr << "Failed to load model: " << e.what() << std::endl;
+          it = pending_models_.erase(it);
+          continue;
+        }
+      }
+
+      const auto& meshes = pending_model.model->Meshes();
+      while (pending_model.next_mesh < meshes.size() && uploaded < upload_budget_)
+      {
+        if (mesh_objects_.size() >= max_num_mesh_objects)
+        {
+          std::cerr << "Too many meshes: maximum " << max_num_mesh_objects << std::endl;
+          pending_model.next_mesh = static_cast<int>(meshes.size());
+          break;
+        }
+
+        AddMesh(std::make_unique<vkl::Mesh>(context_, *meshes[pending_model.next_mesh++]), pending_model.transform);
+        uploaded += mesh_objects_.back().mesh->BufferSize();
+      }
+
+      if (pending_model.next_mesh == meshes.size())
+        it = pending_models_.erase(it);
+      else
+        ++it;
+    }
+  }
+
+  // Frustum culls whole objects and selects levels of detail of visible ones
+  void SelectLods(const std::array<glm::vec4, 6>& frustum_planes)
+  {
+    // Pixels covered by a unit length at unit distance
+    const auto pixels_per_unit = 0.5f * height_ * std::abs(camera_.projection[1][1]);
+
+    for (auto& object : mesh_objects_)
+    {
+      const auto& center = object.mesh->Center();
+      const auto world_center = object.transform * glm::vec4(center[0], center[1], center[2], 1.f);
+      const auto world_radius = object.mesh->Radius() * object.scale;
+
+      object.visible = SphereInFrustum(frustum_planes, world_center, world_radius);
+      if (!object.visible)
+        continue;
+
+      // Nearest point of the bounding sphere decides the level
+      const auto distance = glm::length(glm::vec3(world_center) - camera_.eye) - world_radius;
+      if (distance <= 0.f || object.scale <= 0.f)
+      {
+        object.lod = 0;
+        continue;
+      }
+
+      const auto max_error = lod_pixel_error_ * distance / (pixels_per_unit * object.scale);
+      object.lod = object.mesh->SelectLod(max_error);
+    }
+  }
+
+  static bool SphereInFrustum(const std::array<glm::vec4, 6>& frustum_planes, const glm::vec4& center, float radius)
+  {
+    for (const auto& plane : frustum_planes)
+    {
+      if (glm::dot(plane, center) < -radius)
+        return false;
+    }
+    return true;
+  }
+
+  // Visible meshlets of the full resolution level, by frustum and normal cone tests
+  void CullMeshlets(const MeshObject& object, const std::array<glm::vec4, 6>& frustum_planes, std::vector<uint32_t>& visible_meshlets) const
+  {
+    visible_meshlets.clear();
+
+    // Cones are tested in object space
+    const auto eye = glm::vec3(object.transform_inverse * glm::vec4(camera_.eye, 1.f));
+
+    const auto& meshlets = object.mesh->Meshlets();
+    for (int i = 0; i < meshlets.size(); i++)
+    {
+      const auto& meshlet = meshlets[i];
+
+      if (meshlet.cone_cutoff < 1.f)
+      {
+        const auto apex = glm::vec3(meshlet.cone_apex[0], meshlet.cone_apex[1], meshlet.cone_apex[2]);
+        const auto axis = glm::vec3(meshlet.cone_axis[0], meshlet.cone_axis[1], meshlet.cone_axis[2]);
+        if (apex != eye && glm::dot(glm::normalize(apex - eye), axis) >= meshlet.cone_cutoff)
+          continue;
+      }
+
+      const auto center = object.transform * glm::vec4(meshlet.center[0], meshlet.center[1], meshlet.center[2], 1.f);
+      if (SphereInFrustum(frustum_planes, center, meshlet.radius * object.scale))
+        visible_meshlets.push_back(i);
+    }
+  }
+
+  // World space planes with inward unit normals, from the rows of the view projection matrix
+  std::array<glm::vec4, 6> FrustumPlanes() const
+  {
+    const auto m = glm::transpose(camera_.projection * camera_.view);
+
+    // Near plane for a [-1, 1] depth range contains the [0, 1] one, so the test is conservative either way
+    std::array<glm::vec4, 6> planes = {
+      m[3] + m[0], m[3] - m[0],
+      m[3] + m[1], m[3] - m[1],
+      m[3] + m[2], m[3] - m[2],
+    };
+
+    for (auto& plane : planes)
+      plane /= glm::length(glm::vec3(plane));
+    return planes;
+  }
+
   void BuildDrawCommandBuffer(vk::CommandBuffer& command_buffer, int image_index)
   {
     constexpr float line_width = 1.f;
@@ -402,7 +626,7 @@ private:
       { sphere_vbo_->Buffer(), sphere_vbo_->Buffer() },
       { sphere_vbo_->Offset(0), sphere_vbo_->Offset(1) });
 
-    command_buffer.bindIndexBuffer(sphere_vbo_->Buffer(), sphere_vbo_->IndexOffset(), vk::IndexType::eUint32);
+    command_buffer.bindIndexBuffer(sphere_vbo_->Buffer(), sphere_vbo_->IndexOffset(), sphere_vbo_->IndexType());
 
     command_buffer.drawIndexed(sphere_vbo_->NumIndices(), 1, 0, 0, 0);
 
@@ -416,10 +640,42 @@ private:
       { floor_vbo_->Buffer(), floor_vbo_->Buffer(), floor_vbo_->Buffer() },
       { floor_vbo_->Offset(0), floor_vbo_->Offset(1), floor_vbo_->Offset(2) });
 
-    command_buffer.bindIndexBuffer(floor_vbo_->Buffer(), floor_vbo_->IndexOffset(), vk::IndexType::eUint32);
+    command_buffer.bindIndexBuffer(floor_vbo_->Buffer(), floor_vbo_->IndexOffset(), floor_vbo_->IndexType());
 
     command_buffer.drawIndexed(floor_vbo_->NumIndices(), 1, 0, 0, 0);
 
+    // Meshes
+    const auto frustum_planes = FrustumPlanes();
+    SelectLods(frustum_planes);
+    vk::Pipeline bound_pipeline = floor_pipeline_;
+    for (int i = 0; i < mesh_objects_.size(); i++)
+    {
+      auto& object = mesh_objects_[i];
+      if (!object.visible)
+        continue;
+
+      // Consecutive meshes of the same layout, e.g. static batches of a model, share the pipeline
+      const auto pipeline = object.mesh->IsCompressed() ? compressed_mesh_pipeline_
+        : object.mesh->IsInterleaved() ? interleaved_mesh_pipeline_ : color_pipeline_;
+      if (pipeline != bound_pipeline)
+      {
+        command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+        bound_pipeline = pipeline;
+      }
+
+      command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline_layout_, 0,
+        { descriptor_sets_[image_index] }, { model_ubos_[image_index].Stride() * (3 + i), 0ull });
+
+      // Partially visible full resolution meshes draw only their visible clusters
+      if (object.lod == 0 && !object.mesh->Meshlets().empty())
+      {
+        CullMeshlets(object, frustum_planes, visible_meshlets_);
+        object.mesh->DrawMeshlets(command_buffer, visible_meshlets_);
+      }
+      else
+        object.mesh->Draw(command_buffer, object.lod);
+    }
+
     // Cubeskin support lines
     command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, cubeskin_support_lines_pipeline_);
 
@@ -518,7 +774,7 @@ private:
     color_attachment
       .setSamples(samples)
       .setLoadOp(vk::AttachmentLoadOp::eClear)
-      .setStoreOp(vk::AttachmentStoreOp::eStore)
+      .setStoreOp(vk::AttachmentStoreOp::eDontCare)
       .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
       .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
       .setInitialLayout(vk::ImageLayout::eUndefined)
@@ -660,7 +916,7 @@ private:
       .setMipmapMode(vk::SamplerMipmapMode::eLinear)
       .setMipLodBias(0.f)
       .setMinLod(0.f)
-      .setMaxLod(static_cast<float>(mip_levels_));
+      .setMaxLod(VK_LOD_CLAMP_NONE); // Textures carry their own full mip chains
 
     sampler_ = device.createSampler(sampler_create_info);
   }
@@ -931,6 +1187,87 @@ private:
 
     color_pipeline_ = device.createGraphicsPipeline(nullptr, graphics_pipeline_create_info).value;
 
+    // Compressed mesh pipeline: same shaders, interleaved 16-bit vertices decoded in the vertex shader
+    {
+      std::vector<vk::VertexInputBindingDescription> compressed_binding_descriptions(1);
+      compressed_binding_descriptions[0]
+        .setBinding(0)
+        .setStride(geometry::Mesh::compressed_stride * sizeof(uint16_t))
+        .setInputRate(vk::VertexInputRate::eVertex);
+
+      std::vector<vk::VertexInputAttributeDescription> compressed_attribute_descriptions(2);
+      compressed_attribute_descriptions[0]
+        .setBinding(0)
+        .setLocation(0)
+        .setFormat(vk::Format::eR16G16B16A16Unorm)
+        .setOffset(0);
+      compressed_attribute_descriptions[1]
+        .setBinding(0)
+        .setLocation(1)
+        .setFormat(vk::Format::eR16G16Snorm)
+        .setOffset(4 * sizeof(uint16_t));
+
+      vk::PipelineVertexInputStateCreateInfo compressed_vertex_input_info;
+      compressed_vertex_input_info
+        .setVertexBindingDescriptions(compressed_binding_descriptions)
+        .setVertexAttributeDescriptions(compressed_attribute_descriptions);
+
+      const vk::Bool32 compressed_vertex = VK_TRUE;
+      vk::SpecializationMapEntry specialization_map_entry;
+      specialization_map_entry
+        .setConstantID(0)
+        .setOffset(0)
+        .setSize(sizeof(vk::Bool32));
+
+      vk::SpecializationInfo specialization_info;
+      specialization_info
+        .setMapEntries(specialization_map_entry)
+        .setDataSize(sizeof(vk::Bool32))
+        .setPData(&compressed_vertex);
+
+      auto compressed_shader_stages = shader_stages;
+      compressed_shader_stages[0].setPSpecializationInfo(&specialization_info);
+
+      auto compressed_pipeline_create_info = graphics_pipeline_create_info;
+      compressed_pipeline_create_info
+        .setPVertexInputState(&compressed_vertex_input_info)
+        .setStages(compressed_shader_stages);
+
+      compressed_mesh_pipeline_ = device.createGraphicsPipeline(nullptr, compressed_pipeline_create_info).value;
+    }
+
+    // Interleaved mesh pipeline: same shaders, float position and normal read from one binding
+    {
+      std::vector<vk::VertexInputBindingDescription> interleaved_binding_descriptions(1);
+      interleaved_binding_descriptions[0]
+        .setBinding(0)
+        .setStride(geometry::Mesh::interleaved_stride * sizeof(float))
+        .setInputRate(vk::VertexInputRate::eVertex);
+
+      std::vector<vk::VertexInputAttributeDescription> interleaved_attribute_descriptions(2);
+      interleaved_attribute_descriptions[0]
+        .setBinding(0)
+        .setLocation(0)
+        .setFormat(vk::Format::eR32G32B32Sfloat)
+        .setOffset(0);
+      interleaved_attribute_descriptions[1]
+        .setBinding(0)
+        .setLocation(1)
+        .setFormat(vk::Format::eR32G32B32Sfloat)
+        .setOffset(3 * sizeof(float));
+
+      vk::PipelineVertexInputStateCreateInfo interleaved_vertex_input_info;
+      interleaved_vertex_input_info
+        .setVertexBindingDescriptions(interleaved_binding_descriptions)
+        .setVertexAttributeDescriptions(interleaved_attribute_descriptions);
+
+      auto interleaved_pipeline_create_info = graphics_pipeline_create_info;
+      interleaved_pipeline_create_info
+        .setPVertexInputState(&interleaved_vertex_input_info);
+
+      interleaved_mesh_pipeline_ = device.createGraphicsPipeline(nullptr, interleaved_pipeline_create_info).value;
+    }
+
     device.destroyShaderModule(vert_shader_module);
     device.destroyShaderModule(frag_shader_module);
     shader_stages.clear();
@@ -1031,6 +1368,8 @@ private:
 
     device.destroyPipelineLayout(pipeline_layout_);
     device.destroyPipeline(color_pipeline_);
+    device.destroyPipeline(compressed_mesh_pipeline_);
+    device.destroyPipeline(interleaved_mesh_pipeline_);
     device.destroyPipeline(floor_pipeline_);
     device.destroyPipeline(cubeskin_support_lines_pipeline_);
   }
@@ -1359,8 +1698,8 @@ private:
     constexpr int sphere_grid_size = 32;
     sphere_ = std::make_unique<Sphere>(sphere_grid_size);
 
-    // Vertex buffers
-    floor_vbo_ = std::make_unique<VertexBuffer>(context_, floor_->NumVertices(), floor_->NumIndices());
+    // Vertex buffers. Generated indices go up to NumVertices() - 1, so 16-bit indices fit up to 65536 vertices.
+    floor_vbo_ = std::make_unique<VertexBuffer>(context_, floor_->NumVertices(), floor_->NumIndices(), floor_->NumVertices() <= 65536);
     (*floor_vbo_)
       .AddAttribute<float, 3>(0)
       .AddAttribute<float, 3>(1)
@@ -1368,21 +1707,30 @@ private:
       .Prepare();
     const uint64_t floor_buffer_size = floor_vbo_->BufferSize();
 
-    sphere_vbo_ = std::make_unique<VertexBuffer>(context_, sphere_->NumVertices(), sphere_->NumIndices());
+    sphere_vbo_ = std::make_unique<VertexBuffer>(context_, sphere_->NumVertices(), sphere_->NumIndices(), sphere_->NumVertices() <= 65536);
     (*sphere_vbo_)
       .AddAttribute<float, 3>(0)
       .AddAttribute<float, 3>(1)
       .Prepare();
     const auto sphere_buffer_size = sphere_vbo_->BufferSize();
 
-    context_->ToGpu(floor_->PositionBuffer(), floor_vbo_->Buffer(), floor_vbo_->Offset(0));
-    context_->ToGpu(floor_->NormalBuffer(), floor_vbo_->Buffer(), floor_vbo_->Offset(1));
-    context_->ToGpu(floor_->TexCoordBuffer(), floor_vbo_->Buffer(), floor_vbo_->Offset(2));
-    context_->ToGpu(floor_->IndexBuffer(), floor_vbo_->Buffer(), floor_vbo_->IndexOffset());
-
-    context_->ToGpu(sphere_->PositionBuffer(), sphere_vbo_->Buffer(), sphere_vbo_->Offset(0));
-    context_->ToGpu(sphere_->NormalBuffer(), sphere_vbo_->Buffer(), sphere_vbo_->Offset(1));
-    context_->ToGpu(sphere_->IndexBuffer(), sphere_vbo_->Buffer(), sphere_vbo_->IndexOffset());
+    // Generated straight into the stage buffer, one transfer per primitive
+    context_->ToGpu(floor_buffer_size, floor_vbo_->Buffer(), 0, [this](void* map) {
+      auto* data = static_cast<uint8_t*>(map);
+      floor_->Generate(
+        AttributeRegion(data, *floor_vbo_, 0, 3),
+        AttributeRegion(data, *floor_vbo_, 1, 3),
+        AttributeRegion(data, *floor_vbo_, 2, 2));
+      GenerateIndices(*floor_, *floor_vbo_, data);
+      });
+
+    context_->ToGpu(sphere_buffer_size, sphere_vbo_->Buffer(), 0, [this](void* map) {
+      auto* data = static_cast<uint8_t*>(map);
+      sphere_->Generate(
+        AttributeRegion(data, *sphere_vbo_, 0, 3),
+        AttributeRegion(data, *sphere_vbo_, 1, 3));
+      GenerateIndices(*sphere_, *sphere_vbo_, data);
+      });
 
     // Cubeskin
     constexpr int segments = 32;
@@ -1398,6 +1746,21 @@ private:
     };
   }
 
+  // Planar attribute region of a vertex buffer within its mapped staging copy
+  static AttributeSpan AttributeRegion(uint8_t* data, const VertexBuffer& vertex_buffer, int index, int size)
+  {
+    return AttributeSpan{ reinterpret_cast<float*>(data + vertex_buffer.Offset(index)), size };
+  }
+
+  template <typename Primitive>
+  static void GenerateIndices(const Primitive& primitive, const VertexBuffer& vertex_buffer, uint8_t* data)
+  {
+    if (vertex_buffer.IndexType() == vk::IndexType::eUint16)
+      primitive.GenerateIndices(reinterpret_cast<uint16_t*>(data + vertex_buffer.IndexOffset()));
+    else
+      primitive.GenerateIndices(reinterpret_cast<uint32_t*>(data + vertex_buffer.IndexOffset()));
+  }
+
   void CleanupResources()
   {
     const auto device = context_->Device();
@@ -1405,6 +1768,8 @@ private:
 
     floor_vbo_.reset();
     sphere_vbo_.reset();
+    mesh_objects_.clear();
+    pending_models_.clear();
     uniform_buffer_.reset();
 
     cubeskin_.reset();
@@ -1509,7 +1874,6 @@ private:
   std::vector<vk::Framebuffer> framebuffers_;
 
   // Sampler
-  uint32_t mip_levels_ = 1;
   vk::Sampler sampler_;
 
   // Descriptor set
@@ -1520,6 +1884,8 @@ private:
   // Pipelines
   vk::PipelineLayout pipeline_layout_;
   vk::Pipeline color_pipeline_;
+  vk::Pipeline compressed_mesh_pipeline_;
+  vk::Pipeline interleaved_mesh_pipeline_;
   vk::Pipeline floor_pipeline_;
 
   // Cubeskin pipeline
@@ -1564,6 +1930,16 @@ private:
   // Model
   std::unique_ptr<Cubeskin> cubeskin_;
 
+  // Meshes
+  static constexpr uint32_t max_num_mesh_objects = 1024;
+  std::vector<MeshObject> mesh_objects_;
+  float lod_pixel_error_ = 1.f;
+  std::vector<uint32_t> visible_meshlets_;
+
+  // Streamed models
+  std::vector<PendingModel> pending_models_;
+  uint64_t upload_budget_ = 16 * 1024 * 1024;
+
   // Draw command buffers
   std::vector<vk::CommandBuffer> draw_command_buffers_;
 
@@ -1603,6 +1979,31 @@ void Engine::UpdateCamera(std::shared_ptr<scene::Camera> camera)
   impl_->UpdateCamera(camera);
 }
 
+void Engine::AddModel(std::shared_ptr<geometry::Model> model, const glm::mat4& transform)
+{
+  impl_->AddModel(model, transform);
+}
+
+void Engine::AddModel(const geometry::MeshCache::View& view, const glm::mat4& transform)
+{
+  impl_->AddModel(view, transform);
+}
+
+void Engine::AddModel(std::future<std::shared_ptr<geometry::Model>>&& model, const glm::mat4& transform)
+{
+  impl_->AddModel(std::move(model), transform);
+}
+
+void Engine::SetUploadBudget(uint64_t upload_budget)
+{
+  impl_->SetUploadBudget(upload_budget);
+}
+
+void Engine::SetLodPixelError(float pixel_error)
+{
+  impl_->SetLodPixelError(pixel_error);
+}
+
 void Engine::SetDrawWireframe()
 {
   impl_->SetDrawWireframe();
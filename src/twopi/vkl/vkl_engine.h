@@ -1,10 +1,14 @@
 #ifndef TWOPI_VKL_VKL_ENGINE_H_
 #define TWOPI_VKL_VKL_ENGINE_H_
 
+#include <future>
 #include <memory>
 #include <vector>
 
+#include <glm/glm.hpp>
+
 #include <twopi/core/timestamp.h>
+#include <twopi/geometry/mesh_cache.h>
 
 namespace twopi
 {
@@ -13,6 +17,11 @@ namespace window
 class Window;
 }
 
+namespace geometry
+{
+class Model;
+}
+
 namespace scene
 {
 class Light;
@@ -33,6 +42,23 @@ public:
   void UpdateLights(const std::vector<std::shared_ptr<scene::Light>>& lights);
   void UpdateCamera(std::shared_ptr<scene::Camera> camera);
 
+  // Uploads every mesh of the model, drawn with the given model transform
+  void AddModel(std::shared_ptr<geometry::Model> model, const glm::mat4& transform);
+
+  // Uploads every mesh straight from a mapped cache, e.g. from MeshLoader::MapCache on a warm start.
+  // The view only needs to outlive the call.
+  void AddModel(const geometry::MeshCache::View& view, const glm::mat4& transform);
+
+  // Adds the model once the future is ready, e.g. from MeshLoader::LoadAsync.
+  // Its meshes are uploaded over the following frames within the upload budget.
+  void AddModel(std::future<std::shared_ptr<geometry::Model>>&& model, const glm::mat4& transform);
+
+  // Bytes of streamed meshes uploaded per frame, 16MB by default. At least one mesh is uploaded each frame.
+  void SetUploadBudget(uint64_t upload_budget);
+
+  // Screen space error in pixels allowed when selecting mesh levels of detail, 1 by default
+  void SetLodPixelError(float pixel_error);
+
   // Draw setting
   void SetDrawWireframe();
   void SetDrawNormal(bool draw_normal);
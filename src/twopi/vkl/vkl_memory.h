@@ -7,11 +7,32 @@ namespace twopi
 {
 namespace vkl
 {
+// What memory is used for, in MemoryStatistics. Indices sharing a buffer with vertices count toward the size of
+// INDEX, while the allocation counts once under VERTEX.
+enum class MemoryCategory : uint32_t
+{
+  VERTEX,
+  INDEX,
+  UNIFORM,
+  IMAGE,
+  STAGING,
+  OTHER,
+  COUNT,
+};
+
 struct Memory
 {
   vk::DeviceMemory device_memory;
   vk::DeviceSize offset = 0;
   vk::DeviceSize size = 0;
+
+  // Host address of offset for persistently mapped memory, nullptr otherwise
+  void* map = nullptr;
+
+  MemoryCategory category = MemoryCategory::OTHER;
+
+  // Bytes at the end of a vertex buffer allocation that hold indices
+  vk::DeviceSize index_size = 0;
 };
 }
 }
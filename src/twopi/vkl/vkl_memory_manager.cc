@@ -1,5 +1,10 @@
 #include <twopi/vkl/vkl_memory_manager.h>
 
+#include <algorithm>
+#include <limits>
+#include <string>
+
+#include <twopi/core/error.h>
 #include <twopi/vkl/vkl_context.h>
 #include <twopi/vkl/vkl_memory.h>
 
@@ -7,140 +12,319 @@ namespace twopi
 {
 namespace vkl
 {
+namespace
+{
+int CountFlags(vk::MemoryPropertyFlags flags)
+{
+  int count = 0;
+  for (auto bits = static_cast<VkMemoryPropertyFlags>(flags); bits != 0; bits &= bits - 1)
+    count++;
+  return count;
+}
+}
+
 MemoryManager::MemoryManager(Context* context)
   : context_(context)
 {
   const auto physical_device = context_->PhysicalDevice();
-  const auto device = context_->Device();
 
-  uint32_t device_index = 0;
+  buffer_image_granularity_ = physical_device.getProperties().limits.bufferImageGranularity;
 
-  // Find memroy type index
-  uint64_t device_available_size = 0;
-  uint64_t host_available_size = 0;
-  const auto memory_properties = physical_device.getMemoryProperties();
-  for (uint32_t i = 0; i < memory_properties.memoryTypeCount; i++)
+  memory_properties_ = physical_device.getMemoryProperties();
+  for (uint32_t i = 0; i < memory_properties_.memoryTypeCount; i++)
   {
-    const auto properties = memory_properties.memoryTypes[i].propertyFlags;
-    const auto heap_index = memory_properties.memoryTypes[i].heapIndex;
-    const auto heap = memory_properties.memoryHeaps[heap_index];
-
-    if ((properties & vk::MemoryPropertyFlagBits::eDeviceLocal) == vk::MemoryPropertyFlagBits::eDeviceLocal)
-    {
-      if (heap.size > device_available_size)
-      {
-        device_index = i;
-        device_available_size = heap.size;
-      }
-    }
+    const auto heap = memory_properties_.memoryHeaps[memory_properties_.memoryTypes[i].heapIndex];
 
-    if ((properties & (vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent))
-      == (vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent))
-    {
-      if (heap.size > host_available_size)
-      {
-        host_index_ = i;
-        host_available_size = heap.size;
-      }
-    }
+    // Small heaps, e.g. device local host visible memory, get smaller blocks
+    constexpr uint64_t max_block_size = 256 * 1024 * 1024; // 256MB
+    block_sizes_[i] = std::min(max_block_size, heap.size / 8);
   }
+}
+
+MemoryManager::~MemoryManager()
+{
+  const auto device = context_->Device();
 
-  constexpr uint64_t chunk_size = 256 * 1024 * 1024; // 256MB
+  for (const auto& blocks : blocks_)
+  {
+    for (const auto& block : blocks)
+      device.freeMemory(block->device_memory);
+  }
+}
 
-  vk::MemoryAllocateInfo allocate_info;
-  allocate_info
-    .setAllocationSize(chunk_size)
-    .setMemoryTypeIndex(device_index);
-  device_memory_ = device.allocateMemory(allocate_info);
+Memory MemoryManager::AllocateDeviceMemory(vk::Buffer buffer, MemoryCategory category)
+{
+  const auto device = context_->Device();
 
-  allocate_info
-    .setMemoryTypeIndex(host_index_);
-  host_memory_ = device.allocateMemory(allocate_info);
+  return Allocate(Usage::DEVICE, device.getBufferMemoryRequirements(buffer), false, false, category);
 }
 
-MemoryManager::~MemoryManager()
+Memory MemoryManager::AllocateDeviceMemory(vk::Image image, MemoryCategory category)
 {
   const auto device = context_->Device();
 
-  device.freeMemory(device_memory_);
-  device.freeMemory(host_memory_);
+  return Allocate(Usage::DEVICE, device.getImageMemoryRequirements(image), true, false, category);
 }
 
-Memory MemoryManager::AllocateDeviceMemory(vk::Buffer buffer)
+Memory MemoryManager::AllocateVertexMemory(vk::Buffer buffer, vk::DeviceSize index_size)
+{
+  auto memory = AllocateDeviceMemory(buffer, MemoryCategory::VERTEX);
+  memory.index_size = std::min(index_size, memory.size);
+
+  std::lock_guard<std::mutex> guard{ allocate_mutex_ };
+  categories_[static_cast<size_t>(MemoryCategory::VERTEX)].size -= memory.index_size;
+  categories_[static_cast<size_t>(MemoryCategory::INDEX)].size += memory.index_size;
+  return memory;
+}
+
+Memory MemoryManager::AllocateHostMemory(vk::Buffer buffer, MemoryCategory category)
 {
   const auto device = context_->Device();
 
-  return AllocateDeviceMemory(device.getBufferMemoryRequirements(buffer));
+  return Allocate(Usage::HOST, device.getBufferMemoryRequirements(buffer), false, true, category);
 }
 
-Memory MemoryManager::AllocateDeviceMemory(vk::Image image)
+Memory MemoryManager::AllocateHostMemory(vk::Image image, MemoryCategory category)
 {
   const auto device = context_->Device();
 
-  return AllocateDeviceMemory(device.getImageMemoryRequirements(image));
+  return Allocate(Usage::HOST, device.getImageMemoryRequirements(image), true, true, category);
 }
 
-Memory MemoryManager::AllocateHostMemory(vk::Buffer buffer)
+Memory MemoryManager::AllocateReadbackMemory(vk::Buffer buffer, MemoryCategory category)
 {
   const auto device = context_->Device();
 
-  return AllocateHostMemory(device.getBufferMemoryRequirements(buffer));
+  return Allocate(Usage::READBACK, device.getBufferMemoryRequirements(buffer), false, true, category);
 }
 
-Memory MemoryManager::AllocateHostMemory(vk::Image image)
+Memory MemoryManager::AllocateTransientMemory(vk::Image image, MemoryCategory category)
 {
   const auto device = context_->Device();
 
-  return AllocateHostMemory(device.getImageMemoryRequirements(image));
+  return Allocate(Usage::TRANSIENT, device.getImageMemoryRequirements(image), true, false, category);
 }
 
-Memory MemoryManager::AllocatePersistentlyMappedMemory(vk::Image image)
+Memory MemoryManager::AllocatePersistentlyMappedMemory(vk::Image image, MemoryCategory category)
 {
   const auto device = context_->Device();
 
-  return AllocatePersistentlyMappedMemory(device.getImageMemoryRequirements(image));
+  return Allocate(Usage::HOST, device.getImageMemoryRequirements(image), true, true, category);
 }
 
-Memory MemoryManager::AllocatePersistentlyMappedMemory(vk::Buffer buffer)
+Memory MemoryManager::AllocatePersistentlyMappedMemory(vk::Buffer buffer, MemoryCategory category)
 {
   const auto device = context_->Device();
 
-  return AllocatePersistentlyMappedMemory(device.getBufferMemoryRequirements(buffer));
+  return Allocate(Usage::HOST, device.getBufferMemoryRequirements(buffer), false, true, category);
 }
 
-Memory MemoryManager::AllocateDeviceMemory(const vk::MemoryRequirements& requirements)
+void MemoryManager::Free(const Memory& memory)
 {
-  Memory memory;
-  memory.device_memory = device_memory_;
-  memory.offset = (device_memory_offset_ + requirements.alignment - 1ull) & ~(requirements.alignment - 1ull);
-  memory.size = requirements.size;
-  device_memory_offset_ = memory.offset + memory.size;
-  return memory;
+  if (!memory.device_memory)
+    return;
+
+  std::lock_guard<std::mutex> guard{ allocate_mutex_ };
+
+  const auto it = block_map_.find(static_cast<VkDeviceMemory>(memory.device_memory));
+  if (it == block_map_.end())
+    return;
+
+  auto& category_statistics = categories_[static_cast<size_t>(memory.category)];
+  category_statistics.size -= memory.size - memory.index_size;
+  category_statistics.num_allocations--;
+  categories_[static_cast<size_t>(MemoryCategory::INDEX)].size -= memory.index_size;
+
+  auto* block = it->second;
+  block->allocator.Free(memory.offset);
+  if (!block->allocator.IsEmpty())
+    return;
+
+  // One empty block of regular size is kept per memory type, so that load and unload cycles do not churn
+  const auto memory_type_index = block->memory_type_index;
+  auto& blocks = blocks_[memory_type_index];
+  if (blocks.size() == 1 && block->allocator.Size() <= block_sizes_[memory_type_index])
+    return;
+
+  context_->Device().freeMemory(block->device_memory);
+  block_map_.erase(it);
+  blocks.erase(std::find_if(blocks.begin(), blocks.end(), [block](const auto& b) { return b.get() == block; }));
 }
 
-Memory MemoryManager::AllocateHostMemory(const vk::MemoryRequirements& requirements)
+MemoryStatistics MemoryManager::Statistics() const
 {
-  Memory memory;
-  memory.device_memory = host_memory_;
-  memory.offset = (host_memory_offset_ + requirements.alignment - 1ull) & ~(requirements.alignment - 1ull);
-  memory.size = requirements.size;
-  host_memory_offset_ = memory.offset + memory.size;
-  return memory;
+  const auto physical_device = context_->PhysicalDevice();
+
+  MemoryStatistics statistics;
+  statistics.has_memory_budget = context_->HasMemoryBudget();
+
+  statistics.heaps.resize(memory_properties_.memoryHeapCount);
+  for (uint32_t i = 0; i < memory_properties_.memoryHeapCount; i++)
+  {
+    auto& heap = statistics.heaps[i];
+    heap.size = memory_properties_.memoryHeaps[i].size;
+    heap.device_local = static_cast<bool>(memory_properties_.memoryHeaps[i].flags & vk::MemoryHeapFlagBits::eDeviceLocal);
+  }
+
+  // Queried before taking the lock, as the driver may take a while
+  if (statistics.has_memory_budget)
+  {
+    const auto properties = physical_device.getMemoryProperties2<vk::PhysicalDeviceMemoryProperties2, vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+    const auto& budget = properties.get<vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+    for (uint32_t i = 0; i < memory_properties_.memoryHeapCount; i++)
+    {
+      statistics.heaps[i].budget = budget.heapBudget[i];
+      statistics.heaps[i].usage = budget.heapUsage[i];
+    }
+  }
+
+  std::lock_guard<std::mutex> guard{ allocate_mutex_ };
+
+  statistics.categories = categories_;
+
+  for (const auto& blocks : blocks_)
+  {
+    for (const auto& block : blocks)
+    {
+      MemoryStatistics::Block block_statistics;
+      block_statistics.memory_type_index = block->memory_type_index;
+      block_statistics.heap_index = memory_properties_.memoryTypes[block->memory_type_index].heapIndex;
+      block_statistics.mapped = block->map != nullptr;
+      block_statistics.size = block->allocator.Size();
+      block_statistics.used_size = block->allocator.UsedSize();
+      block_statistics.num_allocations = static_cast<uint32_t>(block->allocator.NumAllocations());
+      block_statistics.largest_free_region = block->allocator.LargestFreeRegion();
+      statistics.blocks.push_back(block_statistics);
+
+      auto& heap = statistics.heaps[block_statistics.heap_index];
+      heap.block_size += block_statistics.size;
+      heap.allocated_size += block_statistics.used_size;
+    }
+  }
+
+  if (!statistics.has_memory_budget)
+  {
+    for (auto& heap : statistics.heaps)
+    {
+      heap.budget = heap.size / 10 * 8;
+      heap.usage = heap.block_size;
+    }
+  }
+
+  return statistics;
 }
 
-Memory MemoryManager::AllocatePersistentlyMappedMemory(const vk::MemoryRequirements& requirements)
+uint32_t MemoryManager::FindMemoryType(uint32_t memory_type_bits, Usage usage) const
 {
-  const auto device = context_->Device();
+  vk::MemoryPropertyFlags required;
+  vk::MemoryPropertyFlags preferred;
+  vk::MemoryPropertyFlags avoided;
+  switch (usage)
+  {
+  case Usage::DEVICE:
+    preferred = vk::MemoryPropertyFlagBits::eDeviceLocal;
+    avoided = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eLazilyAllocated;
+    break;
+  case Usage::HOST:
+    required = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+    avoided = vk::MemoryPropertyFlagBits::eHostCached;
+    break;
+  case Usage::READBACK:
+    required = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+    preferred = vk::MemoryPropertyFlagBits::eHostCached;
+    break;
+  case Usage::TRANSIENT:
+    preferred = vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eLazilyAllocated;
+    avoided = vk::MemoryPropertyFlagBits::eHostVisible;
+    break;
+  }
+
+  // Most preferred flags, then fewest avoided flags, then the largest heap
+  uint32_t best_index = VK_MAX_MEMORY_TYPES;
+  int best_score = std::numeric_limits<int>::min();
+  vk::DeviceSize best_heap_size = 0;
+  for (uint32_t i = 0; i < memory_properties_.memoryTypeCount; i++)
+  {
+    const auto properties = memory_properties_.memoryTypes[i].propertyFlags;
+    if (!(memory_type_bits & (1u << i)) || (properties & required) != required)
+      continue;
+
+    const auto score = CountFlags(properties & preferred) * 8 - CountFlags(properties & avoided);
+    const auto heap_size = memory_properties_.memoryHeaps[memory_properties_.memoryTypes[i].heapIndex].size;
+    if (score > best_score || (score == best_score && heap_size > best_heap_size))
+    {
+      best_index = i;
+      best_score = score;
+      best_heap_size = heap_size;
+    }
+  }
+
+  if (best_index == VK_MAX_MEMORY_TYPES)
+    throw core::Error("No compatible memory type for memory type bits " + std::to_string(memory_type_bits));
+  return best_index;
+}
+
+Memory MemoryManager::Allocate(Usage usage, const vk::MemoryRequirements& requirements, bool optimal_image, bool mapped, MemoryCategory category)
+{
+  const auto memory_type_index = FindMemoryType(requirements.memoryTypeBits, usage);
+
+  auto size = requirements.size;
+  auto alignment = requirements.alignment;
+  if (optimal_image)
+  {
+    alignment = std::max(alignment, buffer_image_granularity_);
+    size = (size + buffer_image_granularity_ - 1ull) & ~(buffer_image_granularity_ - 1ull);
+  }
 
-  vk::MemoryAllocateInfo allocate_info;
-  allocate_info
-    .setMemoryTypeIndex(host_index_)
-    .setAllocationSize(requirements.size);
+  std::lock_guard<std::mutex> guard{ allocate_mutex_ };
+
+  Block* block = nullptr;
+  auto offset = TlsfAllocator::invalid_offset;
+  auto& blocks = blocks_[memory_type_index];
+  for (const auto& candidate : blocks)
+  {
+    offset = candidate->allocator.Allocate(size, alignment);
+    if (offset != TlsfAllocator::invalid_offset)
+    {
+      block = candidate.get();
+      break;
+    }
+  }
+
+  if (block == nullptr)
+  {
+    const auto block_size = std::max(block_sizes_[memory_type_index], size);
+
+    vk::MemoryAllocateInfo allocate_info;
+    allocate_info
+      .setAllocationSize(block_size)
+      .setMemoryTypeIndex(memory_type_index);
+    const auto device_memory = context_->Device().allocateMemory(allocate_info);
+
+    blocks.push_back(std::make_unique<Block>(device_memory, memory_type_index, block_size));
+    block = blocks.back().get();
+    block_map_.emplace(static_cast<VkDeviceMemory>(device_memory), block);
+
+    offset = block->allocator.Allocate(size, alignment);
+    if (offset == TlsfAllocator::invalid_offset)
+      throw core::Error("Failed to sub-allocate " + std::to_string(size) + " bytes from a new memory block");
+  }
+
+  // Host blocks are mapped whole on first use and stay mapped until they are freed
+  if (mapped && block->map == nullptr)
+    block->map = context_->Device().mapMemory(block->device_memory, 0, VK_WHOLE_SIZE);
 
   Memory memory;
-  memory.device_memory = device.allocateMemory(allocate_info);
-  memory.offset = 0;
+  memory.device_memory = block->device_memory;
+  memory.offset = offset;
   memory.size = requirements.size;
+  if (mapped)
+    memory.map = static_cast<uint8_t*>(block->map) + offset;
+  memory.category = category;
+
+  auto& category_statistics = categories_[static_cast<size_t>(category)];
+  category_statistics.size += memory.size;
+  category_statistics.num_allocations++;
   return memory;
 }
 }
@@ -1,17 +1,27 @@
 #ifndef TWOPI_VKL_VKL_MEMORY_MANAGER_H_
 #define TWOPI_VKL_VKL_MEMORY_MANAGER_H_
 
+#include <array>
+#include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include <vulkan/vulkan.hpp>
 
+#include <twopi/vkl/vkl_memory.h>
+#include <twopi/vkl/vkl_memory_statistics.h>
+#include <twopi/vkl/vkl_tlsf_allocator.h>
+
 namespace twopi
 {
 namespace vkl
 {
-struct Memory;
 class Context;
 
+// Sub-allocates device and host memory from blocks of vk::DeviceMemory that are allocated per memory type
+// as earlier ones fill up. Allocations larger than a block get a block of their own. The memory type is chosen
+// per request among those the resource's memoryTypeBits allow.
 class MemoryManager
 {
 public:
@@ -19,31 +29,71 @@ public:
   explicit MemoryManager(Context* context);
   ~MemoryManager();
 
-  Memory AllocateDeviceMemory(vk::Buffer buffer);
-  Memory AllocateDeviceMemory(vk::Image image);
+  Memory AllocateDeviceMemory(vk::Buffer buffer, MemoryCategory category);
+  Memory AllocateDeviceMemory(vk::Image image, MemoryCategory category);
+
+  // Device memory of a vertex buffer whose last index_size bytes hold indices, accounted under INDEX
+  Memory AllocateVertexMemory(vk::Buffer buffer, vk::DeviceSize index_size);
+
+  // Host visible memory with Memory::map set. Host blocks may be shared with persistently mapped allocations,
+  // which map them whole, so ranges are never mapped by the caller.
+  Memory AllocateHostMemory(vk::Buffer buffer, MemoryCategory category);
+  Memory AllocateHostMemory(vk::Image image, MemoryCategory category);
+
+  // Host visible memory with Memory::map set, cached where available, for buffers the host reads back from the
+  // GPU. Cached memory that is not host coherent needs vkInvalidateMappedMemoryRanges before reading.
+  Memory AllocateReadbackMemory(vk::Buffer buffer, MemoryCategory category);
+
+  // Lazily allocated memory where available, for attachments with eTransientAttachment usage that are never
+  // stored, e.g. multisample color and depth; device local memory otherwise
+  Memory AllocateTransientMemory(vk::Image image, MemoryCategory category);
 
-  Memory AllocateHostMemory(vk::Buffer buffer);
-  Memory AllocateHostMemory(vk::Image image);
+  // Host memory with Memory::map set, sub-allocated from blocks that are mapped once
+  Memory AllocatePersistentlyMappedMemory(vk::Buffer buffer, MemoryCategory category);
+  Memory AllocatePersistentlyMappedMemory(vk::Image image, MemoryCategory category);
 
-  Memory AllocatePersistentlyMappedMemory(vk::Buffer buffer);
-  Memory AllocatePersistentlyMappedMemory(vk::Image image);
+  // Returns device or host memory to its block, releasing blocks left empty; empty memory is ignored
+  void Free(const Memory& memory);
+
+  MemoryStatistics Statistics() const;
 
 private:
+  struct Block
+  {
+    Block(vk::DeviceMemory device_memory, uint32_t memory_type_index, vk::DeviceSize size)
+      : device_memory(device_memory), memory_type_index(memory_type_index), allocator(size)
+    {
+    }
+
+    vk::DeviceMemory device_memory;
+    uint32_t memory_type_index;
+    TlsfAllocator allocator;
+    void* map = nullptr;
+  };
+
+  enum class Usage
+  {
+    DEVICE,
+    HOST,
+    READBACK,
+    TRANSIENT,
+  };
+
   const Context* context_;
 
-  Memory AllocateDeviceMemory(const vk::MemoryRequirements& requirements);
-  Memory AllocateHostMemory(const vk::MemoryRequirements& requirements);
+  uint32_t FindMemoryType(uint32_t memory_type_bits, Usage usage) const;
 
-  Memory AllocatePersistentlyMappedMemory(const vk::MemoryRequirements& requirements);
+  // Optimal tiling images are padded to buffer image granularity, so that they never share a page with buffers
+  Memory Allocate(Usage usage, const vk::MemoryRequirements& requirements, bool optimal_image, bool mapped, MemoryCategory category);
 
-  std::mutex device_allocate_mutex_;
-  vk::DeviceMemory device_memory_;
-  vk::DeviceSize device_memory_offset_ = 0;
+  vk::PhysicalDeviceMemoryProperties memory_properties_;
+  vk::DeviceSize buffer_image_granularity_ = 1;
 
-  uint32_t host_index_ = 0;
-  std::mutex host_allocate_mutex_;
-  vk::DeviceMemory host_memory_;
-  vk::DeviceSize host_memory_offset_ = 0;
+  mutable std::mutex allocate_mutex_;
+  vk::DeviceSize block_sizes_[VK_MAX_MEMORY_TYPES] = {};
+  std::vector<std::unique_ptr<Block>> blocks_[VK_MAX_MEMORY_TYPES];
+  std::unordered_map<VkDeviceMemory, Block*> block_map_;
+  std::array<MemoryStatistics::Category, static_cast<size_t>(MemoryCategory::COUNT)> categories_;
 };
 }
 }
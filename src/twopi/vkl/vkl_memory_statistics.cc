@@ -0,0 +1,70 @@
+#include <twopi/vkl/vkl_memory_statistics.h>
+
+#include <sstream>
+
+namespace twopi
+{
+namespace vkl
+{
+const char* MemoryCategoryName(MemoryCategory category)
+{
+  switch (category)
+  {
+  case MemoryCategory::VERTEX: return "vertex";
+  case MemoryCategory::INDEX: return "index";
+  case MemoryCategory::UNIFORM: return "uniform";
+  case MemoryCategory::IMAGE: return "image";
+  case MemoryCategory::STAGING: return "staging";
+  case MemoryCategory::OTHER: return "other";
+  default: return "unknown";
+  }
+}
+
+std::string ToJson(const MemoryStatistics& statistics)
+{
+  std::ostringstream out;
+  out << "{\"has_memory_budget\":" << (statistics.has_memory_budget ? "true" : "false");
+
+  out << ",\"categories\":{";
+  for (size_t i = 0; i < statistics.categories.size(); i++)
+  {
+    const auto& category = statistics.categories[i];
+    out << (i > 0 ? "," : "") << '"' << MemoryCategoryName(static_cast<MemoryCategory>(i)) << "\":"
+      << "{\"size\":" << category.size
+      << ",\"num_allocations\":" << category.num_allocations << '}';
+  }
+  out << '}';
+
+  out << ",\"heaps\":[";
+  for (size_t i = 0; i < statistics.heaps.size(); i++)
+  {
+    const auto& heap = statistics.heaps[i];
+    out << (i > 0 ? "," : "")
+      << "{\"size\":" << heap.size
+      << ",\"device_local\":" << (heap.device_local ? "true" : "false")
+      << ",\"budget\":" << heap.budget
+      << ",\"usage\":" << heap.usage
+      << ",\"block_size\":" << heap.block_size
+      << ",\"allocated_size\":" << heap.allocated_size << '}';
+  }
+  out << ']';
+
+  out << ",\"blocks\":[";
+  for (size_t i = 0; i < statistics.blocks.size(); i++)
+  {
+    const auto& block = statistics.blocks[i];
+    out << (i > 0 ? "," : "")
+      << "{\"memory_type_index\":" << block.memory_type_index
+      << ",\"heap_index\":" << block.heap_index
+      << ",\"mapped\":" << (block.mapped ? "true" : "false")
+      << ",\"size\":" << block.size
+      << ",\"used_size\":" << block.used_size
+      << ",\"num_allocations\":" << block.num_allocations
+      << ",\"largest_free_region\":" << block.largest_free_region << '}';
+  }
+  out << "]}";
+
+  return out.str();
+}
+}
+}
@@ -0,0 +1,66 @@
+#ifndef TWOPI_VKL_VKL_MEMORY_STATISTICS_H_
+#define TWOPI_VKL_VKL_MEMORY_STATISTICS_H_
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include <twopi/vkl/vkl_memory.h>
+
+namespace twopi
+{
+namespace vkl
+{
+// Snapshot of vkl::MemoryManager, from Context::MemoryStatistics
+struct MemoryStatistics
+{
+  struct Category
+  {
+    vk::DeviceSize size = 0;
+    uint32_t num_allocations = 0;
+  };
+
+  struct Heap
+  {
+    vk::DeviceSize size = 0;
+    bool device_local = false;
+
+    // From VK_EXT_memory_budget when the device supports it. Otherwise the budget is 80% of the heap and
+    // the usage counts this process's blocks only.
+    vk::DeviceSize budget = 0;
+    vk::DeviceSize usage = 0;
+
+    // Bytes in blocks of the memory manager, and sub-allocated from them
+    vk::DeviceSize block_size = 0;
+    vk::DeviceSize allocated_size = 0;
+  };
+
+  struct Block
+  {
+    uint32_t memory_type_index = 0;
+    uint32_t heap_index = 0;
+    bool mapped = false;
+    vk::DeviceSize size = 0;
+    vk::DeviceSize used_size = 0;
+    uint32_t num_allocations = 0;
+
+    // Fragmentation shows as a largest free region well below size - used_size
+    vk::DeviceSize largest_free_region = 0;
+  };
+
+  bool has_memory_budget = false;
+  std::array<Category, static_cast<size_t>(MemoryCategory::COUNT)> categories;
+  std::vector<Heap> heaps;
+  std::vector<Block> blocks;
+};
+
+const char* MemoryCategoryName(MemoryCategory category);
+
+// Single JSON object, e.g. for logs or a leak check between scene loads
+std::string ToJson(const MemoryStatistics& statistics);
+}
+}
+
+#endif // TWOPI_VKL_VKL_MEMORY_STATISTICS_H_
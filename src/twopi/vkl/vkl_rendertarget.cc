@@ -31,14 +31,14 @@ Rendertarget::Rendertarget(std::shared_ptr<vkl::Context> context, uint32_t max_w
     .setFormat(format);
   auto limit_color_image = device.createImage(image_create_info);
 
-  color_image_memory_ = context->AllocateDeviceMemory(limit_color_image);
+  color_image_memory_ = context->AllocateTransientMemory(limit_color_image, MemoryCategory::IMAGE);
 
   image_create_info
-    .setUsage(vk::ImageUsageFlagBits::eDepthStencilAttachment)
+    .setUsage(vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eTransientAttachment)
     .setFormat(vk::Format::eD24UnormS8Uint);
   auto limit_depth_image = device.createImage(image_create_info);
 
-  depth_image_memory_ = context->AllocateDeviceMemory(limit_depth_image);
+  depth_image_memory_ = context->AllocateTransientMemory(limit_depth_image, MemoryCategory::IMAGE);
 
   device.destroyImage(limit_color_image);
   device.destroyImage(limit_depth_image);
@@ -74,7 +74,7 @@ Rendertarget::Rendertarget(std::shared_ptr<vkl::Context> context, uint32_t max_w
 
   // Create multisample depth image
   image_create_info
-    .setUsage(vk::ImageUsageFlagBits::eDepthStencilAttachment)
+    .setUsage(vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eTransientAttachment)
     .setFormat(vk::Format::eD24UnormS8Uint);
   depth_image_ = device.createImage(image_create_info);
 
@@ -100,6 +100,9 @@ Rendertarget::~Rendertarget()
 
   device.destroyImage(depth_image_);
   device.destroyImageView(depth_image_view_);
+
+  Context()->FreeMemory(color_image_memory_);
+  Context()->FreeMemory(depth_image_memory_);
 }
 }
 }
@@ -13,6 +13,7 @@ StageBuffer::StageBuffer(vkl::Context* context)
   : context_(context)
 {
   constexpr vk::DeviceSize buffer_size = 32 * 1024 * 1024; // 32MB
+  size_ = buffer_size;
 
   const auto device = context->Device();
 
@@ -23,8 +24,8 @@ StageBuffer::StageBuffer(vkl::Context* context)
     .setSize(buffer_size);
   buffer_ = device.createBuffer(buffer_create_info);
 
-  memory_ = context->AllocatePersistentlyMappedMemory(buffer_);
-  map_ = device.mapMemory(memory_.device_memory, memory_.offset, memory_.size);
+  memory_ = context->AllocatePersistentlyMappedMemory(buffer_, MemoryCategory::STAGING);
+  map_ = memory_.map;
   device.bindBufferMemory(buffer_, memory_.device_memory, memory_.offset);
 }
 
@@ -32,10 +33,33 @@ StageBuffer::~StageBuffer()
 {
   const auto device = context_->Device();
 
-  device.unmapMemory(memory_.device_memory);
-  device.freeMemory(memory_.device_memory);
-
   device.destroyBuffer(buffer_);
+  context_->FreeMemory(memory_);
+}
+
+vk::DeviceSize StageBuffer::Allocate(vk::DeviceSize size, vk::DeviceSize alignment)
+{
+  const auto capacity = size_;
+
+  // An empty ring restarts at offset 0, so that any size up to the capacity fits
+  if (head_ == tail_)
+    head_ = tail_ = (head_ + capacity - 1) / capacity * capacity;
+
+  // Regions do not wrap around; the end of the buffer is skipped instead
+  auto begin = (head_ + alignment - 1) & ~(alignment - 1);
+  if (begin % capacity + size > capacity)
+    begin = (begin + capacity - 1) / capacity * capacity;
+
+  if (begin + size - tail_ > capacity)
+    return invalid_offset;
+
+  head_ = begin + size;
+  return begin % capacity;
+}
+
+void StageBuffer::Release(vk::DeviceSize head)
+{
+  tail_ = std::max(tail_, head);
 }
 
 StageBuffer::operator void* const () const
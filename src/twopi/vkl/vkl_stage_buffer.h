@@ -8,8 +8,13 @@ namespace twopi
 {
 namespace vkl
 {
+// Persistently mapped ring of staging memory. Positions are byte counters that only grow, and map to offsets
+// modulo the buffer size; regions are released in the order they were allocated.
 class StageBuffer
 {
+public:
+  static constexpr vk::DeviceSize invalid_offset = ~0ull;
+
 public:
   StageBuffer() = delete;
 
@@ -18,16 +23,32 @@ public:
   ~StageBuffer();
 
   auto Buffer() const { return buffer_; }
+  vk::DeviceSize Size() const { return size_; }
+
+  // Buffer offset of size bytes, or invalid_offset until earlier regions are released. size is at most Size(),
+  // and alignment a power of two dividing it.
+  vk::DeviceSize Allocate(vk::DeviceSize size, vk::DeviceSize alignment);
+
+  // Position after the last allocation, e.g. recorded when the copies reading it are submitted
+  vk::DeviceSize Head() const { return head_; }
+
+  // Frees everything allocated before head
+  void Release(vk::DeviceSize head);
 
   operator void* const () const;
   operator void* ();
 
 private:
-  const Context* context_;
+  Context* context_;
 
   vk::Buffer buffer_;
+  // Size the buffer was created with; memory_.size may be padded beyond it by memory requirements
+  vk::DeviceSize size_ = 0;
   Memory memory_;
   void* map_;
+
+  vk::DeviceSize head_ = 0;
+  vk::DeviceSize tail_ = 0;
 };
 }
 }
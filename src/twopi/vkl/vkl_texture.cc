@@ -0,0 +1,185 @@
+#include <twopi/vkl/vkl_texture.h>
+
+#include <cstring>
+
+#include <twopi/core/error.h>
+#include <twopi/geometry/compressed_image.h>
+#include <twopi/geometry/image.h>
+#include <twopi/vkl/vkl_context.h>
+
+namespace twopi
+{
+namespace vkl
+{
+namespace
+{
+vk::Format ImageFormat(int comp, bool srgb)
+{
+  switch (comp)
+  {
+  case 1: return srgb ? vk::Format::eR8Srgb : vk::Format::eR8Unorm;
+  case 2: return srgb ? vk::Format::eR8G8Srgb : vk::Format::eR8G8Unorm;
+  case 4: return srgb ? vk::Format::eR8G8B8A8Srgb : vk::Format::eR8G8B8A8Unorm;
+  default: throw core::Error("Unsupported texture components: " + std::to_string(comp));
+  }
+}
+
+vk::Format HalfFormat(int comp)
+{
+  switch (comp)
+  {
+  case 1: return vk::Format::eR16Sfloat;
+  case 2: return vk::Format::eR16G16Sfloat;
+  case 4: return vk::Format::eR16G16B16A16Sfloat;
+  default: throw core::Error("Unsupported half float texture components: " + std::to_string(comp));
+  }
+}
+
+vk::Format BlockFormat(geometry::BlockFormat format, bool srgb)
+{
+  switch (format)
+  {
+  case geometry::BlockFormat::BC1: return srgb ? vk::Format::eBc1RgbaSrgbBlock : vk::Format::eBc1RgbaUnormBlock;
+  case geometry::BlockFormat::BC3: return srgb ? vk::Format::eBc3SrgbBlock : vk::Format::eBc3UnormBlock;
+  case geometry::BlockFormat::BC5: return vk::Format::eBc5UnormBlock;
+  case geometry::BlockFormat::BC7: return srgb ? vk::Format::eBc7SrgbBlock : vk::Format::eBc7UnormBlock;
+  }
+  return vk::Format::eUndefined;
+}
+
+// Buffer offsets of image copies must be multiples of 4 and of the texel block size
+vk::DeviceSize Align(vk::DeviceSize offset)
+{
+  return (offset + 15ull) & ~15ull;
+}
+}
+
+Texture::Texture(std::shared_ptr<vkl::Context> context, const std::vector<std::shared_ptr<geometry::Image<uint8_t>>>& levels, bool srgb)
+  : Object(context)
+{
+  std::vector<Level> texture_levels;
+  for (const auto& level : levels)
+    texture_levels.push_back({ static_cast<uint32_t>(level->Width()), static_cast<uint32_t>(level->Height()), level->Data(), level->Size(), true });
+
+  Create(ImageFormat(levels[0]->Comp(), srgb), texture_levels);
+}
+
+Texture::Texture(std::shared_ptr<vkl::Context> context, const geometry::CompressedImage& image)
+  : Object(context)
+{
+  std::vector<Level> texture_levels;
+  for (int i = 0; i < image.NumLevels(); i++)
+  {
+    texture_levels.push_back({ static_cast<uint32_t>(image.LevelWidth(i)), static_cast<uint32_t>(image.LevelHeight(i)),
+      image.Level(i).data(), image.Level(i).size(), false });
+  }
+
+  Create(BlockFormat(image.Format(), image.IsSrgb()), texture_levels);
+}
+
+Texture::Texture(std::shared_ptr<vkl::Context> context, const geometry::Image<uint16_t>& image)
+  : Object(context)
+{
+  Create(HalfFormat(image.Comp()),
+    { { static_cast<uint32_t>(image.Width()), static_cast<uint32_t>(image.Height()), image.Data(), image.Size() * sizeof(uint16_t), true } });
+}
+
+Texture::Texture(std::shared_ptr<vkl::Context> context, const geometry::Image<uint32_t>& image)
+  : Object(context)
+{
+  if (image.Comp() != 1)
+    throw core::Error("RGB9E5 textures need one packed component, got " + std::to_string(image.Comp()));
+
+  Create(vk::Format::eE5B9G9R9UfloatPack32,
+    { { static_cast<uint32_t>(image.Width()), static_cast<uint32_t>(image.Height()), image.Data(), image.Size() * sizeof(uint32_t), true } });
+}
+
+Texture::~Texture()
+{
+  const auto device = Context()->Device();
+
+  device.destroyImageView(image_view_);
+  device.destroyImage(image_);
+  Context()->FreeMemory(memory_);
+}
+
+void Texture::Create(vk::Format format, const std::vector<Level>& levels)
+{
+  const auto context = Context();
+  const auto device = context->Device();
+
+  format_ = format;
+  mip_levels_ = static_cast<uint32_t>(levels.size());
+
+  vk::ImageCreateInfo image_create_info;
+  image_create_info
+    .setImageType(vk::ImageType::e2D)
+    .setMipLevels(mip_levels_)
+    .setArrayLayers(1)
+    .setTiling(vk::ImageTiling::eOptimal)
+    .setInitialLayout(vk::ImageLayout::eUndefined)
+    .setSharingMode(vk::SharingMode::eExclusive)
+    .setSamples(vk::SampleCountFlagBits::e1)
+    .setExtent({ levels[0].width, levels[0].height, 1 })
+    .setUsage(vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled)
+    .setFormat(format_);
+  image_ = device.createImage(image_create_info);
+
+  memory_ = context->AllocateDeviceMemory(image_, MemoryCategory::IMAGE);
+  device.bindImageMemory(image_, memory_.device_memory, memory_.offset);
+
+  vk::ImageSubresourceRange image_subresource_range;
+  image_subresource_range
+    .setAspectMask(vk::ImageAspectFlagBits::eColor)
+    .setLevelCount(mip_levels_)
+    .setBaseMipLevel(0)
+    .setLayerCount(1)
+    .setBaseArrayLayer(0);
+
+  vk::ImageViewCreateInfo image_view_create_info;
+  image_view_create_info
+    .setImage(image_)
+    .setViewType(vk::ImageViewType::e2D)
+    .setComponents(vk::ComponentMapping{})
+    .setFormat(format_)
+    .setSubresourceRange(image_subresource_range);
+  image_view_ = device.createImageView(image_view_create_info);
+
+  // Every level packed into one stage region and copied by one command
+  std::vector<vk::BufferImageCopy> regions;
+  vk::DeviceSize offset = 0;
+  for (uint32_t i = 0; i < mip_levels_; i++)
+  {
+    vk::BufferImageCopy region;
+    region
+      .setBufferOffset(offset)
+      .setBufferRowLength(0)
+      .setBufferImageHeight(0)
+      .setImageSubresource({ vk::ImageAspectFlagBits::eColor, i, 0, 1 })
+      .setImageOffset({ 0, 0, 0 })
+      .setImageExtent({ levels[i].width, levels[i].height, 1 });
+    regions.push_back(region);
+
+    offset = Align(offset + levels[i].size);
+  }
+
+  context->ToGpu(offset, image_, mip_levels_, regions, [&levels, &regions](void* map) {
+    for (int i = 0; i < levels.size(); i++)
+    {
+      auto* dst = static_cast<uint8_t*>(map) + regions[i].bufferOffset;
+      const auto* src = static_cast<const uint8_t*>(levels[i].data);
+      if (!levels[i].bottom_up)
+      {
+        std::memcpy(dst, src, levels[i].size);
+        continue;
+      }
+
+      // Top row first, as compressed levels are stored
+      const auto row_size = levels[i].size / levels[i].height;
+      for (uint32_t y = 0; y < levels[i].height; y++)
+        std::memcpy(dst + y * row_size, src + (levels[i].height - 1 - y) * row_size, row_size);
+    }
+    });
+}
+}
+}
@@ -0,0 +1,72 @@
+#ifndef TWOPI_VKL_VKL_TEXTURE_H_
+#define TWOPI_VKL_VKL_TEXTURE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include <twopi/vkl/vkl_object.h>
+#include <twopi/vkl/vkl_memory.h>
+
+namespace twopi
+{
+namespace geometry
+{
+template <typename T>
+class Image;
+class CompressedImage;
+}
+
+namespace vkl
+{
+// Sampled 2D image with every mip level uploaded from the CPU in one staging pass, so that no blit chain runs
+// on the GPU. Images with 1, 2 or 4 components map to R8, R8G8 and R8G8B8A8 formats.
+// Every format is uploaded top row first, so that v = 0 samples the top of the image: block compressed levels
+// as stored, and the bottom-up rows of geometry::Image reversed while staging.
+class Texture : public Object
+{
+public:
+  Texture() = delete;
+
+  // Levels from full resolution down, e.g. from geometry::MipmapGenerator
+  Texture(std::shared_ptr<vkl::Context> context, const std::vector<std::shared_ptr<geometry::Image<uint8_t>>>& levels, bool srgb);
+
+  // All levels of a block compressed image, e.g. a cached DDS file
+  Texture(std::shared_ptr<vkl::Context> context, const geometry::CompressedImage& image);
+
+  // Half float image with 1, 2 or 4 components from geometry::ConvertToHalf, as R16 to R16G16B16A16 formats
+  Texture(std::shared_ptr<vkl::Context> context, const geometry::Image<uint16_t>& image);
+
+  // Shared exponent image from geometry::ConvertToRgb9e5, as the E5B9G9R9 format
+  Texture(std::shared_ptr<vkl::Context> context, const geometry::Image<uint32_t>& image);
+
+  ~Texture() override;
+
+  auto Image() const { return image_; }
+  auto ImageView() const { return image_view_; }
+  auto Format() const { return format_; }
+  auto MipLevels() const { return mip_levels_; }
+
+private:
+  struct Level
+  {
+    uint32_t width;
+    uint32_t height;
+    const void* data;
+    vk::DeviceSize size;
+    // Rows of geometry::Image, stored from the bottom
+    bool bottom_up;
+  };
+
+  void Create(vk::Format format, const std::vector<Level>& levels);
+
+  vk::Format format_ = vk::Format::eUndefined;
+  uint32_t mip_levels_ = 0;
+
+  vk::Image image_;
+  vk::ImageView image_view_;
+  Memory memory_;
+};
+}
+}
+
+#endif // TWOPI_VKL_VKL_TEXTURE_H_
@@ -0,0 +1,287 @@
+#include <twopi/vkl/vkl_tlsf_allocator.h>
+
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace twopi
+{
+namespace vkl
+{
+namespace
+{
+// Free regions smaller than this stay attached to the allocation before them
+constexpr uint64_t min_split_size = 64;
+
+int HighestBit(uint64_t value)
+{
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanReverse64(&index, value);
+  return static_cast<int>(index);
+#else
+  return 63 - __builtin_clzll(value);
+#endif
+}
+
+int LowestBit(uint64_t value)
+{
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward64(&index, value);
+  return static_cast<int>(index);
+#else
+  return __builtin_ctzll(value);
+#endif
+}
+}
+
+TlsfAllocator::TlsfAllocator(uint64_t size)
+  : size_(size)
+{
+  for (auto& heads : free_heads_)
+    std::fill(std::begin(heads), std::end(heads), invalid_node);
+
+  InsertFree(CreateNode(0, size));
+}
+
+TlsfAllocator::~TlsfAllocator() = default;
+
+uint64_t TlsfAllocator::Allocate(uint64_t size, uint64_t alignment)
+{
+  size = std::max<uint64_t>(size, 1);
+  alignment = std::max<uint64_t>(alignment, 1);
+
+  if (size > size_)
+    return invalid_offset;
+
+  auto node = FindGoodFit(size, alignment);
+  if (node == invalid_node)
+    node = FindExactFit(size, alignment);
+  if (node == invalid_node)
+    return invalid_offset;
+  RemoveFree(node);
+
+  // Padding before the aligned offset is left as a free region
+  const auto offset = (nodes_[node].offset + alignment - 1) & ~(alignment - 1);
+  if (offset != nodes_[node].offset)
+  {
+    const auto front = node;
+    SplitFree(front, offset);
+    node = nodes_[front].next_physical;
+    RemoveFree(node);
+    InsertFree(front);
+  }
+
+  if (nodes_[node].size - size >= min_split_size)
+    SplitFree(node, offset + size);
+
+  nodes_[node].is_free = false;
+  used_size_ += nodes_[node].size;
+  allocations_.emplace(offset, node);
+  return offset;
+}
+
+void TlsfAllocator::Free(uint64_t offset)
+{
+  const auto it = allocations_.find(offset);
+  if (it == allocations_.end())
+    return;
+
+  auto node = it->second;
+  allocations_.erase(it);
+  used_size_ -= nodes_[node].size;
+
+  const auto next = nodes_[node].next_physical;
+  if (next != invalid_node && nodes_[next].is_free)
+  {
+    RemoveFree(next);
+    nodes_[node].size += nodes_[next].size;
+    nodes_[node].next_physical = nodes_[next].next_physical;
+    if (nodes_[node].next_physical != invalid_node)
+      nodes_[nodes_[node].next_physical].prev_physical = node;
+    DestroyNode(next);
+  }
+
+  const auto prev = nodes_[node].prev_physical;
+  if (prev != invalid_node && nodes_[prev].is_free)
+  {
+    RemoveFree(prev);
+    nodes_[prev].size += nodes_[node].size;
+    nodes_[prev].next_physical = nodes_[node].next_physical;
+    if (nodes_[prev].next_physical != invalid_node)
+      nodes_[nodes_[prev].next_physical].prev_physical = prev;
+    DestroyNode(node);
+    node = prev;
+  }
+
+  InsertFree(node);
+}
+
+uint32_t TlsfAllocator::FindGoodFit(uint64_t size, uint64_t alignment) const
+{
+  // Rounded up to the next size class, so that any free region in the class fits even after alignment
+  auto search_size = size + alignment - 1;
+  search_size += search_size < small_size ? small_size / sl_count - 1 : (1ull << (HighestBit(search_size) - sl_bits)) - 1;
+
+  int fl;
+  int sl;
+  Mapping(search_size, fl, sl);
+  if (fl >= fl_count)
+    return invalid_node;
+
+  auto sl_map = sl_bitmaps_[fl] & (~0u << sl);
+  if (sl_map == 0)
+  {
+    const auto fl_map = fl + 1 < 64 ? fl_bitmap_ & (~0ull << (fl + 1)) : 0ull;
+    if (fl_map == 0)
+      return invalid_node;
+
+    fl = LowestBit(fl_map);
+    sl_map = sl_bitmaps_[fl];
+  }
+  sl = LowestBit(sl_map);
+
+  return free_heads_[fl][sl];
+}
+
+uint32_t TlsfAllocator::FindExactFit(uint64_t size, uint64_t alignment) const
+{
+  // Only classes below the rounded one can be left, so this scans few lists, e.g. the single free region of a
+  // block sized exactly for one allocation
+  int fl;
+  int sl;
+  Mapping(size, fl, sl);
+
+  for (; fl < fl_count; fl++, sl = 0)
+  {
+    if (!(fl_bitmap_ & (1ull << fl)))
+      continue;
+
+    for (auto sl_map = sl_bitmaps_[fl] & (~0u << sl); sl_map != 0; sl_map &= sl_map - 1)
+    {
+      for (auto node = free_heads_[fl][LowestBit(sl_map)]; node != invalid_node; node = nodes_[node].next_free)
+      {
+        const auto offset = (nodes_[node].offset + alignment - 1) & ~(alignment - 1);
+        if (offset + size <= nodes_[node].offset + nodes_[node].size)
+          return node;
+      }
+    }
+  }
+
+  return invalid_node;
+}
+
+uint64_t TlsfAllocator::LargestFreeRegion() const
+{
+  if (fl_bitmap_ == 0)
+    return 0;
+
+  const auto fl = HighestBit(fl_bitmap_);
+  const auto sl = HighestBit(sl_bitmaps_[fl]);
+  uint64_t largest = 0;
+  for (auto node = free_heads_[fl][sl]; node != invalid_node; node = nodes_[node].next_free)
+    largest = std::max(largest, nodes_[node].size);
+  return largest;
+}
+
+void TlsfAllocator::Mapping(uint64_t size, int& fl, int& sl)
+{
+  // Linear classes below small_size, then sl_count classes per power of two
+  if (size < small_size)
+  {
+    fl = 0;
+    sl = static_cast<int>(size / (small_size / sl_count));
+  }
+  else
+  {
+    const auto log = HighestBit(size);
+    fl = log - small_bits + 1;
+    sl = static_cast<int>((size >> (log - sl_bits)) ^ (1ull << sl_bits));
+  }
+}
+
+uint32_t TlsfAllocator::CreateNode(uint64_t offset, uint64_t size)
+{
+  uint32_t node;
+  if (unused_nodes_.empty())
+  {
+    node = static_cast<uint32_t>(nodes_.size());
+    nodes_.emplace_back();
+  }
+  else
+  {
+    node = unused_nodes_.back();
+    unused_nodes_.pop_back();
+    nodes_[node] = Node{};
+  }
+
+  nodes_[node].offset = offset;
+  nodes_[node].size = size;
+  return node;
+}
+
+void TlsfAllocator::DestroyNode(uint32_t node)
+{
+  unused_nodes_.push_back(node);
+}
+
+void TlsfAllocator::InsertFree(uint32_t node)
+{
+  int fl;
+  int sl;
+  Mapping(nodes_[node].size, fl, sl);
+
+  auto& head = free_heads_[fl][sl];
+  nodes_[node].is_free = true;
+  nodes_[node].prev_free = invalid_node;
+  nodes_[node].next_free = head;
+  if (head != invalid_node)
+    nodes_[head].prev_free = node;
+  head = node;
+
+  fl_bitmap_ |= 1ull << fl;
+  sl_bitmaps_[fl] |= 1u << sl;
+}
+
+void TlsfAllocator::RemoveFree(uint32_t node)
+{
+  int fl;
+  int sl;
+  Mapping(nodes_[node].size, fl, sl);
+
+  const auto prev = nodes_[node].prev_free;
+  const auto next = nodes_[node].next_free;
+  if (prev != invalid_node)
+    nodes_[prev].next_free = next;
+  else
+    free_heads_[fl][sl] = next;
+  if (next != invalid_node)
+    nodes_[next].prev_free = prev;
+
+  nodes_[node].is_free = false;
+  if (free_heads_[fl][sl] == invalid_node)
+  {
+    sl_bitmaps_[fl] &= ~(1u << sl);
+    if (sl_bitmaps_[fl] == 0)
+      fl_bitmap_ &= ~(1ull << fl);
+  }
+}
+
+void TlsfAllocator::SplitFree(uint32_t node, uint64_t offset)
+{
+  const auto tail = CreateNode(offset, nodes_[node].offset + nodes_[node].size - offset);
+  nodes_[node].size = offset - nodes_[node].offset;
+
+  nodes_[tail].prev_physical = node;
+  nodes_[tail].next_physical = nodes_[node].next_physical;
+  if (nodes_[tail].next_physical != invalid_node)
+    nodes_[nodes_[tail].next_physical].prev_physical = tail;
+  nodes_[node].next_physical = tail;
+
+  InsertFree(tail);
+}
+}
+}
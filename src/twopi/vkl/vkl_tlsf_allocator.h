@@ -0,0 +1,92 @@
+#ifndef TWOPI_VKL_VKL_TLSF_ALLOCATOR_H_
+#define TWOPI_VKL_VKL_TLSF_ALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace twopi
+{
+namespace vkl
+{
+// Two-level segregated fit allocator over the offsets of a range, e.g. one vk::DeviceMemory block. Only
+// bookkeeping is kept on the host: allocation and free are O(1), and freed regions merge with free
+// neighbors immediately so that the range does not fragment over load and unload cycles.
+class TlsfAllocator
+{
+public:
+  static constexpr uint64_t invalid_offset = ~0ull;
+
+public:
+  TlsfAllocator() = delete;
+  explicit TlsfAllocator(uint64_t size);
+  ~TlsfAllocator();
+
+  // Offset of size bytes aligned to a power of two alignment, or invalid_offset if no free region fits
+  uint64_t Allocate(uint64_t size, uint64_t alignment);
+
+  // Releases the allocation starting at offset
+  void Free(uint64_t offset);
+
+  uint64_t Size() const { return size_; }
+  uint64_t UsedSize() const { return used_size_; }
+  size_t NumAllocations() const { return allocations_.size(); }
+  bool IsEmpty() const { return allocations_.empty(); }
+
+  // Largest allocation that still fits without alignment, for fragmentation statistics
+  uint64_t LargestFreeRegion() const;
+
+private:
+  static constexpr int sl_bits = 5;
+  static constexpr int sl_count = 1 << sl_bits;
+  static constexpr int small_bits = 8;
+  static constexpr uint64_t small_size = 1ull << small_bits;
+  static constexpr int fl_count = 64 - small_bits + 1;
+  static constexpr uint32_t invalid_node = ~0u;
+
+  struct Node
+  {
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    uint32_t prev_physical = invalid_node;
+    uint32_t next_physical = invalid_node;
+    uint32_t prev_free = invalid_node;
+    uint32_t next_free = invalid_node;
+    bool is_free = false;
+  };
+
+  static void Mapping(uint64_t size, int& fl, int& sl);
+
+  // Free node from the first class whose every region fits, in O(1)
+  uint32_t FindGoodFit(uint64_t size, uint64_t alignment) const;
+
+  // Free node that fits, scanning the classes below the good fit, for requests close to the largest region
+  uint32_t FindExactFit(uint64_t size, uint64_t alignment) const;
+
+  uint32_t CreateNode(uint64_t offset, uint64_t size);
+  void DestroyNode(uint32_t node);
+
+  void InsertFree(uint32_t node);
+  void RemoveFree(uint32_t node);
+
+  // Splits the tail of node from offset into a new free node
+  void SplitFree(uint32_t node, uint64_t offset);
+
+  uint64_t size_ = 0;
+  uint64_t used_size_ = 0;
+
+  std::vector<Node> nodes_;
+  std::vector<uint32_t> unused_nodes_;
+
+  uint64_t fl_bitmap_ = 0;
+  uint32_t sl_bitmaps_[fl_count] = {};
+  uint32_t free_heads_[fl_count][sl_count];
+
+  // Offset to node of live allocations
+  std::unordered_map<uint64_t, uint32_t> allocations_;
+};
+}
+}
+
+#endif // TWOPI_VKL_VKL_TLSF_ALLOCATOR_H_
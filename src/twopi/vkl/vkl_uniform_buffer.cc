@@ -22,18 +22,17 @@ UniformBuffer::UniformBuffer(std::shared_ptr<vkl::Context> context)
     .setSize(256 * 1024 * 1024); // 256MB
 
   buffer_ = device.createBuffer(buffer_create_info);
-  memory_ = context->AllocatePersistentlyMappedMemory(buffer_);
+  memory_ = context->AllocatePersistentlyMappedMemory(buffer_, MemoryCategory::UNIFORM);
   device.bindBufferMemory(buffer_, memory_.device_memory, memory_.offset);
-  map_ = static_cast<unsigned char*>(device.mapMemory(memory_.device_memory, memory_.offset, memory_.size));
+  map_ = static_cast<unsigned char*>(memory_.map);
 }
 
 UniformBuffer::~UniformBuffer()
 {
   const auto device = Context()->Device();
 
-  device.unmapMemory(memory_.device_memory);
-  device.freeMemory(memory_.device_memory);
   device.destroyBuffer(buffer_);
+  Context()->FreeMemory(memory_);
 }
 }
 }
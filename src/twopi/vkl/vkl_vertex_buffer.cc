@@ -17,10 +17,11 @@ vk::DeviceSize Align(vk::DeviceSize offset, vk::DeviceSize align)
 }
 }
 
-VertexBuffer::VertexBuffer(std::shared_ptr<vkl::Context> context, int num_vertices, int num_indices)
+VertexBuffer::VertexBuffer(std::shared_ptr<vkl::Context> context, int num_vertices, int num_indices, bool short_indices)
   : Object{ context }
   , num_vertices_{ num_vertices }
   , num_indices_{ num_indices }
+  , short_indices_{ short_indices }
 {
 }
 
@@ -29,6 +30,13 @@ VertexBuffer::~VertexBuffer()
   const auto device = Context()->Device();
 
   device.destroyBuffer(buffer_);
+  Context()->FreeMemory(memory_);
+}
+
+VertexBuffer& VertexBuffer::SetInterleaved()
+{
+  interleaved_ = true;
+  return *this;
 }
 
 void VertexBuffer::Prepare()
@@ -39,21 +47,44 @@ void VertexBuffer::Prepare()
     return lhs.index < rhs.index;
     });
 
-  offsets_.push_back(0);
-  sizes_.push_back(attributes_[0].byte_size * attributes_[0].size * num_vertices_);
-  for (int i = 1; i < attributes_.size(); i++)
+  vk::DeviceSize vertex_region_size = 0;
+  if (interleaved_)
+  {
+    // Attribute offsets within a vertex, and stride aligned to the largest component type
+    vk::DeviceSize offset = 0;
+    vk::DeviceSize max_alignment = 1;
+    for (const auto& attribute : attributes_)
+    {
+      offset = Align(offset, attribute.byte_size);
+      offsets_.push_back(offset);
+      sizes_.push_back(attribute.byte_size * attribute.size);
+      offset += sizes_.back();
+      max_alignment = std::max<vk::DeviceSize>(max_alignment, attribute.byte_size);
+    }
+
+    stride_ = static_cast<uint32_t>(Align(offset, max_alignment));
+    vertex_region_size = static_cast<vk::DeviceSize>(stride_) * num_vertices_;
+  }
+  else
   {
-    const auto offset = Align(offsets_[i - 1] + sizes_[i - 1], attributes_[i].byte_size);
-    offsets_.push_back(offset);
-    sizes_.push_back(attributes_[i].byte_size * attributes_[i].size * num_vertices_);
+    offsets_.push_back(0);
+    sizes_.push_back(attributes_[0].byte_size * attributes_[0].size * num_vertices_);
+    for (int i = 1; i < attributes_.size(); i++)
+    {
+      const auto offset = Align(offsets_[i - 1] + sizes_[i - 1], attributes_[i].byte_size);
+      offsets_.push_back(offset);
+      sizes_.push_back(attributes_[i].byte_size * attributes_[i].size * num_vertices_);
+    }
+
+    vertex_region_size = offsets_.back() + sizes_.back();
   }
 
-  index_offset_ = Align(offsets_.back() + sizes_.back(), sizeof(uint32_t));
-  index_size_ = sizeof(uint32_t) * num_indices_;
+  const vk::DeviceSize index_byte_size = short_indices_ ? sizeof(uint16_t) : sizeof(uint32_t);
+  index_type_ = index_byte_size == sizeof(uint16_t) ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
+  index_offset_ = Align(vertex_region_size, index_byte_size);
+  index_size_ = index_byte_size * num_indices_;
 
-  buffer_size_ = index_size_;
-  for (auto size : sizes_)
-    buffer_size_ += size;
+  buffer_size_ = index_offset_ + index_size_;
 
   vk::BufferCreateInfo buffer_create_info;
   buffer_create_info
@@ -62,10 +93,39 @@ void VertexBuffer::Prepare()
     .setSize(buffer_size_);
   buffer_ = device.createBuffer(buffer_create_info);
 
-  memory_ = Context()->AllocateDeviceMemory(buffer_);
+  memory_ = Context()->AllocateVertexMemory(buffer_, index_size_);
   device.bindBufferMemory(buffer_, memory_.device_memory, memory_.offset);
 }
 
+void VertexBuffer::UploadIndices(const std::vector<uint32_t>& indices, uint32_t first_index)
+{
+  UploadIndices(indices.data(), indices.size(), first_index);
+}
+
+void VertexBuffer::UploadIndices(const uint32_t* indices, size_t num_indices, uint32_t first_index)
+{
+  if (index_type_ == vk::IndexType::eUint16)
+  {
+    Context()->ToGpu(num_indices * sizeof(uint16_t), buffer_, index_offset_ + first_index * sizeof(uint16_t), [indices, num_indices](void* map) {
+      std::copy_n(indices, num_indices, static_cast<uint16_t*>(map));
+      });
+  }
+  else
+    Context()->ToGpu(indices, num_indices * sizeof(uint32_t), buffer_, index_offset_ + first_index * sizeof(uint32_t));
+}
+
+void VertexBuffer::UploadIndices(const uint16_t* indices, size_t num_indices, uint32_t first_index)
+{
+  if (index_type_ == vk::IndexType::eUint32)
+  {
+    Context()->ToGpu(num_indices * sizeof(uint32_t), buffer_, index_offset_ + first_index * sizeof(uint32_t), [indices, num_indices](void* map) {
+      std::copy_n(indices, num_indices, static_cast<uint32_t*>(map));
+      });
+  }
+  else
+    Context()->ToGpu(indices, num_indices * sizeof(uint16_t), buffer_, index_offset_ + first_index * sizeof(uint16_t));
+}
+
 vk::DeviceSize VertexBuffer::IndexOffset() const
 {
   return index_offset_;
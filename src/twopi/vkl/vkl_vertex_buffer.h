@@ -27,7 +27,8 @@ private:
 public:
   VertexBuffer() = delete;
 
-  VertexBuffer(std::shared_ptr<vkl::Context> context, int num_vertices, int num_indices);
+  // 16-bit indices if short_indices is set, e.g. from geometry::Mesh::HasShortIndices()
+  VertexBuffer(std::shared_ptr<vkl::Context> context, int num_vertices, int num_indices, bool short_indices);
 
   ~VertexBuffer() override;
 
@@ -43,15 +44,34 @@ public:
     return *this;
   }
 
+  // Store all attributes of a vertex contiguously in a single binding
+  VertexBuffer& SetInterleaved();
+
   void Prepare();
 
+  // Copies indices to the index region from first_index on, narrowed to 16-bit in the stage buffer when
+  // IndexType() is eUint16
+  void UploadIndices(const std::vector<uint32_t>& indices, uint32_t first_index = 0);
+  void UploadIndices(const uint32_t* indices, size_t num_indices, uint32_t first_index = 0);
+
+  // 16-bit indices, e.g. straight from a mapped mesh cache, widened in the stage buffer when IndexType() is eUint32
+  void UploadIndices(const uint16_t* indices, size_t num_indices, uint32_t first_index = 0);
+
   int NumIndices() const { return num_indices_; }
 
+  vk::IndexType IndexType() const { return index_type_; }
+
   vk::DeviceSize IndexOffset() const;
   vk::DeviceSize IndexSize() const;
+
+  // Planar layout: byte offset/size of the attribute region in the buffer
+  // Interleaved layout: byte offset/size of the attribute within a vertex
   vk::DeviceSize Offset(int index) const;
   vk::DeviceSize Size(int index) const;
 
+  bool IsInterleaved() const { return interleaved_; }
+  uint32_t Stride() const { return stride_; }
+
   auto BufferSize() const { return buffer_size_; }
 
   auto Buffer() const { return buffer_; }
@@ -59,10 +79,15 @@ public:
 private:
   int num_vertices_;
   int num_indices_;
+  bool short_indices_;
+
+  bool interleaved_ = false;
+  uint32_t stride_ = 0;
 
   std::vector<Attribute> attributes_;
   std::vector<vk::DeviceSize> offsets_;
   std::vector<vk::DeviceSize> sizes_;
+  vk::IndexType index_type_ = vk::IndexType::eUint32;
   vk::DeviceSize index_offset_ = 0;
   vk::DeviceSize index_size_ = 0;
   vk::DeviceSize buffer_size_ = 0;
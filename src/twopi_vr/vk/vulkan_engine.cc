@@ -4,7 +4,6 @@
 #include <iostream>
 #include <fstream>
 #include <set>
-#include <unordered_map>
 #include <unordered_set>
 #include <chrono>
 
@@ -1432,8 +1431,8 @@ void VulkanEngine::LoadModel(const std::string& obj_filename)
   if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, obj_filename.c_str()))
     throw std::runtime_error(warn + err);
 
-  std::unordered_map<Vertex, uint32_t, Vertex::Hash> unique_vertices{};
-
+  // One vertex per face corner, welded afterwards
+  std::vector<Vertex> corners;
   for (const auto& shape : shapes)
   {
     for (const auto& index : shape.mesh.indices)
@@ -1453,15 +1452,21 @@ void VulkanEngine::LoadModel(const std::string& obj_filename)
 
       vertex.color = { 1.0f, 1.0f, 1.0f };
 
-      if (unique_vertices.count(vertex) == 0)
-      {
-        unique_vertices[vertex] = static_cast<uint32_t>(vertices_.size());
-        vertices_.push_back(vertex);
-      }
-
-      indices_.push_back(unique_vertices[vertex]);
+      corners.push_back(vertex);
     }
   }
+
+  static_assert(sizeof(Vertex) % sizeof(float) == 0, "Vertex must consist of floats");
+
+  std::vector<uint32_t> remap;
+  const auto num_unique_vertices = welder_.BuildRemap(reinterpret_cast<const float*>(corners.data()), corners.size(), sizeof(Vertex) / sizeof(float), remap);
+
+  vertices_.resize(num_unique_vertices);
+  for (size_t i = 0; i < corners.size(); i++)
+  {
+    vertices_[remap[i]] = corners[i];
+    indices_.push_back(remap[i]);
+  }
 }
 
 void VulkanEngine::CreateVertexBuffer()
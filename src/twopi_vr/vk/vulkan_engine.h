@@ -13,7 +13,8 @@
 #include <vulkan/vulkan_win32.h>
 
 #include <glm/glm.hpp>
-#include <glm/gtx/hash.hpp>
+
+#include <twopi/geometry/mesh_welder.h>
 
 namespace twopi
 {
@@ -98,14 +99,6 @@ private:
     {
       return pos == other.pos && color == other.color && texCoord == other.texCoord;
     }
-
-    struct Hash
-    {
-      size_t operator () (twopi::vk::VulkanEngine::Vertex const& vertex) const
-      {
-        return ((std::hash<glm::vec3>()(vertex.pos) ^ (std::hash<glm::vec3>()(vertex.color) << 1)) >> 1) ^ (std::hash<glm::vec2>()(vertex.texCoord) << 1);
-      }
-    };
   };
 
   struct UniformBufferObject
@@ -252,6 +245,9 @@ private:
   std::vector<Vertex> vertices_;
   std::vector<uint32_t> indices_;
 
+  // Kept across loads, so that its thread pool is created once
+  geometry::MeshWelder welder_;
+
   VkBuffer vertex_buffer_ = nullptr;
   VkDeviceMemory vertex_buffer_memory_ = nullptr;
 